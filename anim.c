@@ -0,0 +1,192 @@
+#include "anim.h"
+#include <string.h>
+
+// ===== EASING =====
+
+q15_t anim_ease(uint8_t ease, q15_t t) {
+    if (t <= 0) return 0;
+    if (t >= Q15_ONE) return Q15_ONE;
+
+    q15_t inv = Q15_ONE - t;
+    switch (ease) {
+        case ANIM_EASE_IN:
+            return q15_mul(t, t);
+        case ANIM_EASE_OUT:
+            return Q15_ONE - q15_mul(inv, inv);
+        case ANIM_EASE_IN_OUT:
+            if (t < Q15_ONE / 2) return 2 * q15_mul(t, t);
+            return Q15_ONE - 2 * q15_mul(inv, inv);
+        case ANIM_EASE_SINE:
+            // Progress maps onto half a turn (32768), close enough to Q15_ONE
+            return (Q15_ONE - fx_cos((angle_t)t)) / 2;
+        default:
+            return t;
+    }
+}
+
+// Position within an animation of the given length, elapsed ms in
+static uint32_t anim_local_time(uint32_t elapsed, uint32_t length, uint8_t mode) {
+    if (length == 0) return 0;
+
+    switch (mode) {
+        case ANIM_LOOP:
+            return elapsed % length;
+        case ANIM_PINGPONG: {
+            uint32_t p = elapsed % (2 * length);
+            return p <= length ? p : 2 * length - p;
+        }
+        default:
+            return elapsed < length ? elapsed : length;
+    }
+}
+
+// ===== TWEENS =====
+
+void anim_tween_play(anim_tween_t *tween, const anim_key_t *keys, uint8_t count,
+                     uint8_t mode, uint64_t now_us) {
+    tween->keys = keys;
+    tween->count = count;
+    tween->mode = mode;
+    tween->start_us = now_us;
+}
+
+int32_t anim_tween_value(const anim_tween_t *tween, uint64_t now_us) {
+    if (tween->count == 0) return 0;
+
+    const anim_key_t *keys = tween->keys;
+    uint32_t elapsed = (uint32_t)((now_us - tween->start_us) / 1000);
+    uint32_t t = anim_local_time(elapsed, keys[tween->count - 1].time_ms, tween->mode);
+    if (t <= keys[0].time_ms) return keys[0].value;
+
+    for (uint8_t i = 1; i < tween->count; i++) {
+        if (t > keys[i].time_ms) continue;
+
+        const anim_key_t *a = &keys[i - 1];
+        const anim_key_t *b = &keys[i];
+        uint32_t span = b->time_ms - a->time_ms;
+        q15_t progress = span ? (q15_t)((t - a->time_ms) * Q15_ONE / span) : Q15_ONE;
+        q15_t e = anim_ease(b->ease, progress);
+
+        // Divide by Q15_ONE rather than shift, so e == Q15_ONE lands on b exactly
+        int64_t d = (int64_t)(b->value - a->value) * e;
+        return a->value + (int32_t)((d + (d >= 0 ? Q15_ONE / 2 : -Q15_ONE / 2)) / Q15_ONE);
+    }
+    return keys[tween->count - 1].value;
+}
+
+bool anim_tween_done(const anim_tween_t *tween, uint64_t now_us) {
+    if (tween->count == 0) return true;
+    if (tween->mode != ANIM_ONCE) return false;
+
+    return (now_us - tween->start_us) / 1000 >= tween->keys[tween->count - 1].time_ms;
+}
+
+// ===== FRAME SEQUENCES =====
+
+uint8_t anim_clip_frame(const anim_clip_t *clip, uint32_t elapsed_ms) {
+    if (clip->count <= 1 || clip->frame_ms == 0) return 0;
+
+    uint32_t n = elapsed_ms / clip->frame_ms;
+    switch (clip->mode) {
+        case ANIM_LOOP:
+            return n % clip->count;
+        case ANIM_PINGPONG: {
+            // The end frames show once per pass, not twice
+            uint32_t period = 2 * clip->count - 2;
+            uint32_t p = n % period;
+            return p < clip->count ? p : period - p;
+        }
+        default:
+            return n < clip->count ? n : clip->count - 1u;
+    }
+}
+
+// ===== FRAME CACHE =====
+
+bool anim_cache_init(anim_cache_t *cache, uint8_t count, uint16_t width, uint16_t height,
+                     uint16_t capacity, anim_record_fn record, void *ctx) {
+    memset(cache, 0, sizeof(*cache));
+    if (count == 0 || count > ANIM_CACHE_FRAMES) return false;
+
+    for (uint8_t i = 0; i < count; i++) {
+        if (!display_list_init(&cache->frames[i], width, height, capacity)) {
+            // Newest first, so each one goes back to the arena
+            while (i > 0) display_list_free(&cache->frames[--i]);
+            return false;
+        }
+    }
+
+    cache->count = count;
+    cache->record = record;
+    cache->ctx = ctx;
+    return true;
+}
+
+static void record_frame(anim_cache_t *cache, uint8_t frame) {
+    if (cache->recorded & (1u << frame)) return;
+    display_list_clear(&cache->frames[frame]);
+    cache->record(&cache->frames[frame], frame, cache->ctx);
+    cache->recorded |= 1u << frame;
+}
+
+bool anim_cache_prepare(anim_cache_t *cache) {
+    if (cache->count == 0) return false;
+
+    // Rasters first, so the scratch sprite above them can be given back
+    for (uint8_t i = 0; i < cache->count; i++) {
+        if (!display_list_reserve(&cache->frames[i])) return false;
+    }
+
+    display_list_t *first = &cache->frames[0];
+    arena_mark_t mark = arena_mark(first->arena);
+    sprite_t *scratch = sprite_create_in(first->arena, first->width, first->height);
+    if (!scratch) return false;
+
+    for (uint8_t i = 0; i < cache->count; i++) {
+        record_frame(cache, i);
+        display_list_prepare(&cache->frames[i], scratch);
+    }
+
+    arena_release(first->arena, mark);
+    return true;
+}
+
+void anim_cache_set_color(anim_cache_t *cache, uint8_t index, uint16_t color) {
+    for (uint8_t i = 0; i < cache->count; i++) {
+        display_list_set_color(&cache->frames[i], index, color);
+    }
+}
+
+void anim_cache_draw(anim_cache_t *cache, uint8_t frame, sprite_t *sprite) {
+    if (frame >= cache->count) return;
+    display_list_t *dl = &cache->frames[frame];
+
+    // Which frame the sprite holds, if we drew it last
+    uint8_t slot = 0;
+    bool found = false;
+    for (uint8_t i = 0; i < DISPLAY_LIST_TARGETS; i++) {
+        if (cache->targets[i].sprite == sprite) {
+            slot = i;
+            found = true;
+            break;
+        }
+        if (!cache->targets[i].sprite) slot = i;
+    }
+
+    // The frame's list may remember this sprite from before it showed
+    // something else
+    if (!found || cache->targets[slot].frame != frame) {
+        display_list_forget(dl, sprite);
+    }
+
+    record_frame(cache, frame);
+    display_list_draw(dl, sprite);
+
+    // No room to keep this frame's raster: draw it the slow way, every time
+    if (!dl->cache && sprite->width == dl->width && sprite->height == dl->height) {
+        display_list_render(dl, sprite, 0, 0);
+    }
+
+    cache->targets[slot].sprite = sprite;
+    cache->targets[slot].frame = frame;
+}
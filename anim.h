@@ -0,0 +1,130 @@
+#ifndef ANIM_H
+#define ANIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "display.h"
+#include "displaylist.h"
+#include "fixed.h"
+
+// Time-driven animation. Everything here is a function of elapsed time,
+// not of how often it is called, so it plays at the same speed whatever
+// the update or frame rate:
+//   anim_tween_t   Keyframed value with fixed-point easing between keys
+//   anim_clip_t    Frame sequence timing, for sprite sheets and palette
+//                  cycles
+//   anim_cache_t   Frames recorded as display lists and kept rasterized,
+//                  so showing one again is a palette expansion or nothing
+//                  rather than a redraw
+
+typedef enum {
+    ANIM_ONCE,                // Stop on the last key or frame
+    ANIM_LOOP,
+    ANIM_PINGPONG             // Forwards, then backwards, and again
+} anim_mode_t;
+
+typedef enum {
+    ANIM_LINEAR,
+    ANIM_EASE_IN,             // Quadratic: slow start
+    ANIM_EASE_OUT,            // Quadratic: slow finish
+    ANIM_EASE_IN_OUT,         // Quadratic on both ends
+    ANIM_EASE_SINE            // Half a cosine wave, gentler than quadratic
+} anim_ease_t;
+
+// Map progress 0..Q15_ONE through an easing curve
+q15_t anim_ease(uint8_t ease, q15_t t);
+
+// ===== TWEENS =====
+
+// ease shapes the segment arriving at this key from the previous one;
+// the first key's is unused. Keys must be in time order.
+typedef struct {
+    uint16_t time_ms;
+    int32_t value;
+    uint8_t ease;             // anim_ease_t
+} anim_key_t;
+
+typedef struct {
+    const anim_key_t *keys;
+    uint8_t count;
+    uint8_t mode;             // anim_mode_t
+    uint64_t start_us;
+} anim_tween_t;
+
+// Start (or restart) playing keys from now_us
+void anim_tween_play(anim_tween_t *tween, const anim_key_t *keys, uint8_t count,
+                     uint8_t mode, uint64_t now_us);
+
+// Value at now_us; 0 for a tween that was never played
+int32_t anim_tween_value(const anim_tween_t *tween, uint64_t now_us);
+
+// True once an ANIM_ONCE tween has reached its last key (or never played)
+bool anim_tween_done(const anim_tween_t *tween, uint64_t now_us);
+
+// ===== FRAME SEQUENCES =====
+
+typedef struct {
+    uint8_t count;
+    uint16_t frame_ms;        // How long each frame shows
+    uint8_t mode;             // anim_mode_t
+} anim_clip_t;
+
+// Frame index elapsed_ms into the clip
+uint8_t anim_clip_frame(const anim_clip_t *clip, uint32_t elapsed_ms);
+
+// Sprite sheet: one indexed sprite per frame, usually compiled into flash
+static inline const indexed_sprite_t* anim_sheet_frame(const anim_clip_t *clip,
+                                                       const indexed_sprite_t *frames,
+                                                       uint32_t elapsed_ms) {
+    return &frames[anim_clip_frame(clip, elapsed_ms)];
+}
+
+// Palette cycle: one color per frame, for display_list_set_color or an
+// indexed sprite's palette
+static inline uint16_t anim_palette_color(const anim_clip_t *clip, const uint16_t *colors,
+                                          uint32_t elapsed_ms) {
+    return colors[anim_clip_frame(clip, elapsed_ms)];
+}
+
+// ===== FRAME CACHE =====
+
+#define ANIM_CACHE_FRAMES 8
+
+// Records frame into the (cleared) display list
+typedef void (*anim_record_fn)(display_list_t *dl, uint8_t frame, void *ctx);
+
+typedef struct {
+    display_list_t frames[ANIM_CACHE_FRAMES];
+    uint8_t count;
+    uint8_t recorded;         // Bit per frame
+    anim_record_fn record;
+    void *ctx;
+
+    // Frame each sprite was last given, so a list is never fooled into
+    // skipping a sprite that has since shown another frame
+    struct {
+        const sprite_t *sprite;
+        uint8_t frame;
+    } targets[DISPLAY_LIST_TARGETS];
+} anim_cache_t;
+
+// Set up count frames of width x height with room for capacity
+// primitives each. Each frame keeps a width * height index raster in
+// arena_static once rasterized.
+bool anim_cache_init(anim_cache_t *cache, uint8_t count, uint16_t width, uint16_t height,
+                     uint16_t capacity, anim_record_fn record, void *ctx);
+
+// Record and rasterize every frame now, on the core that owns
+// arena_static, so drawing later allocates nothing. Needs a
+// width x height sprite of scratch on top of the rasters, given back
+// before returning. False if it does not fit; frames left unprepared are
+// still recorded and rasterized on first draw, by the drawing core.
+bool anim_cache_prepare(anim_cache_t *cache);
+
+// Set a palette entry in every frame
+void anim_cache_set_color(anim_cache_t *cache, uint8_t index, uint16_t color);
+
+// Bring the sprite up to date with frame
+void anim_cache_draw(anim_cache_t *cache, uint8_t frame, sprite_t *sprite);
+
+#endif // ANIM_H
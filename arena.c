@@ -0,0 +1,103 @@
+#include "arena.h"
+#include "pico/stdlib.h"
+
+#define ARENA_CORES 2
+
+static uint8_t static_region[ARENA_STATIC_SIZE] __attribute__((aligned(ARENA_ALIGN)));
+static uint8_t frame_regions[ARENA_CORES][ARENA_FRAME_SIZE] __attribute__((aligned(ARENA_ALIGN)));
+
+arena_t arena_static = {.base = static_region, .stats = {.size = ARENA_STATIC_SIZE}};
+static arena_t frame_arenas[ARENA_CORES] = {
+    {.base = frame_regions[0], .stats = {.size = ARENA_FRAME_SIZE}},
+    {.base = frame_regions[1], .stats = {.size = ARENA_FRAME_SIZE}},
+};
+
+// ===== ARENA =====
+
+void arena_init(arena_t *arena, void *mem, uint32_t size) {
+    arena->base = mem;
+    arena->stats = (arena_stats_t){.size = size};
+    arena->last = 0;
+}
+
+void* arena_alloc(arena_t *arena, uint32_t size, uint32_t align) {
+    arena_stats_t *s = &arena->stats;
+
+    // Regions are ARENA_ALIGN aligned, so offsets can be aligned instead
+    // of addresses for anything up to that
+    uintptr_t addr = (uintptr_t)arena->base + s->used;
+    uintptr_t aligned = (addr + align - 1) & ~(uintptr_t)(align - 1);
+    uint32_t start = s->used + (uint32_t)(aligned - addr);
+
+    if (start > s->size || size > s->size - start) {
+        s->failed++;
+        return NULL;
+    }
+
+    arena->last = start;
+    s->used = start + size;
+    if (s->used > s->high_water) s->high_water = s->used;
+    s->allocs++;
+    return arena->base + start;
+}
+
+bool arena_pop(arena_t *arena, void *ptr) {
+    if ((uint8_t *)ptr != arena->base + arena->last || arena->last == arena->stats.used) {
+        return false;
+    }
+
+    // Only one level deep: the allocation before it is not known
+    arena->stats.used = arena->last;
+    return true;
+}
+
+// ===== POOL =====
+
+bool pool_init(pool_t *pool, arena_t *arena, uint32_t block_size, uint16_t capacity) {
+    // Free blocks hold the list link, and every block stays aligned
+    if (block_size < sizeof(void *)) block_size = sizeof(void *);
+    block_size = (block_size + ARENA_ALIGN - 1) & ~(uint32_t)(ARENA_ALIGN - 1);
+
+    uint8_t *blocks = arena_alloc(arena, block_size * capacity, ARENA_ALIGN);
+    if (!blocks) return false;
+
+    pool->free_list = NULL;
+    for (uint16_t i = capacity; i > 0; i--) {
+        void **block = (void **)(blocks + (uint32_t)(i - 1) * block_size);
+        *block = pool->free_list;
+        pool->free_list = block;
+    }
+    pool->block_size = block_size;
+    pool->capacity = capacity;
+    pool->in_use = 0;
+    pool->high_water = 0;
+    return true;
+}
+
+void* pool_alloc(pool_t *pool) {
+    void **block = pool->free_list;
+    if (!block) return NULL;
+
+    pool->free_list = *block;
+    pool->in_use++;
+    if (pool->in_use > pool->high_water) pool->high_water = pool->in_use;
+    return block;
+}
+
+void pool_free(pool_t *pool, void *block) {
+    if (!block) return;
+
+    *(void **)block = pool->free_list;
+    pool->free_list = block;
+    pool->in_use--;
+}
+
+// ===== SHARED ARENAS =====
+
+arena_t* arena_frame(void) {
+    return &frame_arenas[get_core_num()];
+}
+
+void arena_frame_reset(void) {
+    arena_reset(arena_frame());
+}
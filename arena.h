@@ -0,0 +1,106 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Heap-free memory for the firmware. The cyw43/lwIP stack shares the C
+// heap, and sprites created and freed per level would fragment it, so
+// everything else comes from fixed regions:
+//
+//   arena_static    Long-lived data: sprites, display lists, assets loaded
+//                   at runtime. Allocated at init or level load and given
+//                   back in bulk by releasing to a mark.
+//   arena_frame()   Scratch for the calling core, such as line buffers.
+//                   Reset at the start of every frame, and usually
+//                   released sooner by the code that took it.
+//
+// Arenas are not locked: each one belongs to a single core at a time.
+
+// Sizes of the backing regions; override at build time if needed.
+// The static arena peaks at 293344 bytes in the host demo, with both
+// smiley moods cached as 220x220 rasters; 16 KB on top of that is margin.
+// lil_guy_sim prints the peak at the end of a run.
+#ifndef ARENA_STATIC_SIZE
+#define ARENA_STATIC_SIZE   (304 * 1024)
+#endif
+#ifndef ARENA_FRAME_SIZE
+#define ARENA_FRAME_SIZE    (8 * 1024)
+#endif
+
+// Default alignment; enough for 32-bit DMA and 64-bit loads
+#define ARENA_ALIGN         8
+
+typedef struct {
+    uint32_t size;
+    uint32_t used;
+    uint32_t high_water;      // Most ever in use at once
+    uint32_t allocs;
+    uint32_t failed;          // Allocations that did not fit
+} arena_stats_t;
+
+// Bump allocator over a fixed region
+typedef struct {
+    uint8_t *base;
+    arena_stats_t stats;
+    uint32_t last;            // Offset of the latest allocation
+} arena_t;
+
+// Position to release back to
+typedef uint32_t arena_mark_t;
+
+void arena_init(arena_t *arena, void *mem, uint32_t size);
+
+// NULL when it does not fit. align must be a power of two.
+void* arena_alloc(arena_t *arena, uint32_t size, uint32_t align);
+
+static inline arena_mark_t arena_mark(const arena_t *arena) {
+    return arena->stats.used;
+}
+
+// Free everything allocated since the mark
+static inline void arena_release(arena_t *arena, arena_mark_t mark) {
+    if (mark < arena->stats.used) arena->stats.used = mark;
+    if (arena->last > arena->stats.used) arena->last = arena->stats.used;
+}
+
+static inline void arena_reset(arena_t *arena) {
+    arena->stats.used = 0;
+    arena->last = 0;
+}
+
+// Give back ptr if it is the latest allocation; otherwise it stays
+// allocated until the arena is released past it. Returns true if freed.
+bool arena_pop(arena_t *arena, void *ptr);
+
+static inline const arena_stats_t* arena_stats(const arena_t *arena) {
+    return &arena->stats;
+}
+
+// Fixed-size blocks carved from an arena, for objects that come and go
+// individually (entities, particles). Allocation and free are O(1).
+typedef struct {
+    void *free_list;
+    uint32_t block_size;
+    uint16_t capacity;
+    uint16_t in_use;
+    uint16_t high_water;
+} pool_t;
+
+// Carve capacity blocks of block_size bytes (ARENA_ALIGN aligned)
+bool pool_init(pool_t *pool, arena_t *arena, uint32_t block_size, uint16_t capacity);
+void* pool_alloc(pool_t *pool);
+void pool_free(pool_t *pool, void *block);
+
+// ===== SHARED ARENAS =====
+
+extern arena_t arena_static;
+
+// The calling core's frame arena
+arena_t* arena_frame(void);
+
+// Start a new frame on the calling core. Anything still allocated from
+// its frame arena is dropped.
+void arena_frame_reset(void);
+
+#endif // ARENA_H
@@ -0,0 +1,199 @@
+#include "audio.h"
+#include "spsc.h"
+#include "trace.h"
+#include <string.h>
+#include "hardware/gpio.h"
+#include "hardware/pwm.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/clocks.h"
+
+// 8-bit levels; the carrier runs at clk_sys / 256, far above hearing
+#define PWM_WRAP        255
+
+// Samples per DMA buffer (8 ms at 16 kHz); two buffers play in turn, so a
+// new note starts within two blocks
+#define BLOCK_LEN       128
+
+#define CMD_QUEUE_LEN   8
+
+typedef enum {
+    CMD_NOTE,
+    CMD_STOP
+} audio_cmd_type_t;
+
+typedef struct {
+    uint8_t type;             // audio_cmd_type_t
+    audio_note_t note;
+} audio_cmd_t;
+
+// Square-wave voice with a linear attack/sustain/release envelope
+typedef struct {
+    uint32_t phase;
+    uint32_t phase_inc;
+    uint32_t remaining;       // Samples left, 0 when idle
+    uint32_t release_len;     // Release starts when remaining drops to this
+    int32_t env;              // Current amplitude, Q16
+    int32_t env_peak;         // Volume, Q16
+    int32_t attack_step;
+    int32_t release_step;
+} voice_t;
+
+static voice_t voices[AUDIO_VOICES];
+static uint32_t buffers[2][BLOCK_LEN];
+static int dma_chan[2] = {-1, -1};
+static uint8_t level_shift;   // Places the level in the CC half for our channel
+
+static audio_cmd_t cmd_storage[CMD_QUEUE_LEN];
+static spsc_t cmd_queue;
+
+// ===== MIXER (DMA IRQ) =====
+
+static uint32_t ms_to_samples(uint32_t ms) {
+    return ms * AUDIO_SAMPLE_HZ / 1000;
+}
+
+static void start_note(const audio_note_t *note) {
+    // Take an idle voice, or steal the one closest to finishing
+    voice_t *v = &voices[0];
+    for (uint8_t i = 0; i < AUDIO_VOICES; i++) {
+        if (voices[i].remaining < v->remaining) v = &voices[i];
+    }
+
+    uint32_t len = ms_to_samples(note->duration_ms);
+    uint32_t release = ms_to_samples(note->release_ms);
+    uint32_t attack = ms_to_samples(note->attack_ms);
+    if (release > len / 2) release = len / 2;
+    if (attack > len - release) attack = len - release;
+    if (release == 0) release = 1;
+    if (attack == 0) attack = 1;
+
+    v->phase = 0;
+    v->phase_inc = (uint32_t)(((uint64_t)note->freq_hz << 32) / AUDIO_SAMPLE_HZ);
+    v->remaining = len;
+    v->release_len = release;
+    v->env = 0;
+    v->env_peak = (int32_t)note->volume << 16;
+    v->attack_step = v->env_peak / (int32_t)attack;
+    v->release_step = v->env_peak / (int32_t)release;
+}
+
+static void process_commands(void) {
+    audio_cmd_t cmd;
+    while (spsc_pop(&cmd_queue, &cmd)) {
+        if (cmd.type == CMD_NOTE) {
+            start_note(&cmd.note);
+        } else {
+            memset(voices, 0, sizeof(voices));
+        }
+    }
+}
+
+static void mix_block(uint32_t *out) {
+    bool active = false;
+    for (uint8_t i = 0; i < AUDIO_VOICES; i++) {
+        if (voices[i].remaining) active = true;
+    }
+    if (!active) {
+        memset(out, 0, BLOCK_LEN * sizeof(uint32_t));
+        return;
+    }
+
+    for (uint16_t n = 0; n < BLOCK_LEN; n++) {
+        uint32_t level = 0;
+
+        for (uint8_t i = 0; i < AUDIO_VOICES; i++) {
+            voice_t *v = &voices[i];
+            if (!v->remaining) continue;
+
+            if (v->remaining <= v->release_len) {
+                v->env -= v->release_step;
+                if (v->env < 0) v->env = 0;
+            } else if (v->env < v->env_peak) {
+                v->env += v->attack_step;
+                if (v->env > v->env_peak) v->env = v->env_peak;
+            }
+
+            // Unipolar square: silence is a zero level, not mid-scale
+            v->phase += v->phase_inc;
+            if (v->phase & 0x80000000u) {
+                level += (uint32_t)v->env >> 16;
+            }
+            v->remaining--;
+        }
+
+        if (level > PWM_WRAP) level = PWM_WRAP;
+        out[n] = level << level_shift;
+    }
+}
+
+static void audio_dma_irq(void) {
+    for (uint8_t b = 0; b < 2; b++) {
+        if (!dma_channel_get_irq1_status(dma_chan[b])) continue;
+        dma_channel_acknowledge_irq1(dma_chan[b]);
+        TRACE_ZONE(AUDIO_MIX);
+
+        // This buffer has played out and the other is running: refill it
+        // and re-arm its channel for when the other one chains back
+        dma_channel_set_read_addr(dma_chan[b], buffers[b], false);
+        process_commands();
+        mix_block(buffers[b]);
+    }
+}
+
+// ===== PUBLIC API =====
+
+void audio_init(uint gpio) {
+    gpio_set_function(gpio, GPIO_FUNC_PWM);
+    uint slice = pwm_gpio_to_slice_num(gpio);
+    level_shift = pwm_gpio_to_channel(gpio) ? 16 : 0;
+
+    pwm_set_wrap(slice, PWM_WRAP);
+    pwm_set_clkdiv(slice, 1.0f);
+    pwm_set_gpio_level(gpio, 0);
+    pwm_set_enabled(slice, true);
+
+    spsc_init(&cmd_queue, cmd_storage, sizeof(audio_cmd_t), CMD_QUEUE_LEN);
+
+    // Pace samples with a DMA timer derived from the actual system clock
+    uint timer = dma_claim_unused_timer(true);
+    dma_timer_set_fraction(timer, 1, clock_get_hz(clk_sys) / AUDIO_SAMPLE_HZ);
+
+    dma_chan[0] = dma_claim_unused_channel(true);
+    dma_chan[1] = dma_claim_unused_channel(true);
+
+    // Two channels chained into each other play the buffers in turn. Each
+    // sample is a full 32-bit CC write; the other half of the slice drives
+    // the RGB LED pin, which is not in PWM mode, so it is unaffected.
+    for (uint8_t b = 0; b < 2; b++) {
+        dma_channel_config c = dma_channel_get_default_config(dma_chan[b]);
+        channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+        channel_config_set_read_increment(&c, true);
+        channel_config_set_write_increment(&c, false);
+        channel_config_set_dreq(&c, dma_get_timer_dreq(timer));
+        channel_config_set_chain_to(&c, dma_chan[b ^ 1]);
+        dma_channel_configure(dma_chan[b], &c, &pwm_hw->slice[slice].cc,
+                              buffers[b], BLOCK_LEN, false);
+        dma_channel_set_irq1_enabled(dma_chan[b], true);
+    }
+
+    irq_add_shared_handler(DMA_IRQ_1, audio_dma_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_1, true);
+
+    dma_channel_start(dma_chan[0]);
+}
+
+bool audio_play_note(const audio_note_t *note) {
+    audio_cmd_t cmd = {CMD_NOTE, *note};
+    return spsc_push(&cmd_queue, &cmd);
+}
+
+bool audio_play(uint16_t freq_hz, uint16_t duration_ms, uint8_t volume) {
+    audio_note_t note = {freq_hz, duration_ms, volume, 2, 10};
+    return audio_play_note(&note);
+}
+
+void audio_stop_all(void) {
+    audio_cmd_t cmd = {CMD_STOP, {0}};
+    spsc_push(&cmd_queue, &cmd);
+}
@@ -0,0 +1,34 @@
+#ifndef AUDIO_H
+#define AUDIO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/stdlib.h"
+
+// Voices mixed into the buzzer output
+#define AUDIO_VOICES        3
+
+// PCM rate fed to the buzzer PWM
+#define AUDIO_SAMPLE_HZ     16000
+
+typedef struct {
+    uint16_t freq_hz;
+    uint16_t duration_ms;     // Including attack and release
+    uint8_t volume;           // 0-255
+    uint16_t attack_ms;
+    uint16_t release_ms;
+} audio_note_t;
+
+// Drive `gpio` as an 8-bit PWM DAC fed by DMA at AUDIO_SAMPLE_HZ
+void audio_init(uint gpio);
+
+// Queue a note on a free voice (or the one closest to finishing).
+// Returns immediately; false if the command queue is full.
+bool audio_play_note(const audio_note_t *note);
+
+// Square tone with a short click-free envelope
+bool audio_play(uint16_t freq_hz, uint16_t duration_ms, uint8_t volume);
+
+void audio_stop_all(void);
+
+#endif // AUDIO_H
@@ -0,0 +1,169 @@
+#include "blit.h"
+#include <string.h>
+
+// ===== LAYER SPANS =====
+
+// Copy the runs of src that are not the key color
+static void span_colorkey(uint16_t *dst, const uint16_t *src, uint16_t n, uint16_t key) {
+    uint16_t i = 0;
+    while (i < n) {
+        while (i < n && src[i] == key) i++;
+        uint16_t start = i;
+        while (i < n && src[i] != key) i++;
+        if (i > start) memcpy(&dst[start], &src[start], (i - start) * sizeof(uint16_t));
+    }
+}
+
+// col is the sprite column of src[0] within the mask row
+static void span_alpha1(uint16_t *dst, const uint16_t *src, uint16_t n,
+                        const uint8_t *row, uint16_t col) {
+    uint16_t i = 0;
+    while (i < n) {
+        uint16_t bit = col + i;
+        uint8_t byte = row[bit >> 3];
+
+        // Whole mask bytes: eight pixels copied or skipped at once
+        if ((bit & 7) == 0 && n - i >= 8 && (byte == 0xFF || byte == 0x00)) {
+            if (byte) memcpy(&dst[i], &src[i], 8 * sizeof(uint16_t));
+            i += 8;
+            continue;
+        }
+
+        if (byte & (0x80 >> (bit & 7))) dst[i] = src[i];
+        i++;
+    }
+}
+
+static inline uint8_t alpha4_level(const uint8_t *row, uint16_t col) {
+    uint8_t b = row[col >> 1];
+    return col & 1 ? b & 0x0F : b >> 4;
+}
+
+static void span_alpha4(uint16_t *dst, const uint16_t *src, uint16_t n,
+                        const uint8_t *row, uint16_t col) {
+    uint16_t i = 0;
+    while (i < n) {
+        uint8_t level = alpha4_level(row, col + i);
+
+        if (level == 15) {
+            // Opaque run: find its end and copy it in one go
+            uint16_t start = i;
+            do i++; while (i < n && alpha4_level(row, col + i) == 15);
+            memcpy(&dst[start], &src[start], (i - start) * sizeof(uint16_t));
+        } else {
+            if (level) dst[i] = blend565(src[i], dst[i], level * 17);
+            i++;
+        }
+    }
+}
+
+// Composite one layer's part of panel line py into buf, which holds
+// panel columns x0..x1-1
+static void blit_layer_line(const blit_layer_t *l, uint16_t *buf, int16_t x0, int16_t x1, int16_t py) {
+    const sprite_t *s = l->sprite;
+    int16_t sy = py - l->y;
+    if (sy < 0 || sy >= s->height) return;
+
+    int16_t lx0 = l->x > x0 ? l->x : x0;
+    int16_t lx1 = l->x + s->width < x1 ? l->x + s->width : x1;
+    if (lx0 >= lx1) return;
+
+    uint16_t col = lx0 - l->x;
+    uint16_t n = lx1 - lx0;
+    uint16_t *dst = &buf[lx0 - x0];
+    const uint16_t *src = &s->buffer[sy * s->width + col];
+
+    switch (l->mode) {
+        case BLIT_OPAQUE:
+            memcpy(dst, src, n * sizeof(uint16_t));
+            break;
+        case BLIT_COLORKEY:
+            span_colorkey(dst, src, n, l->key);
+            break;
+        case BLIT_ALPHA1:
+            span_alpha1(dst, src, n, l->mask + sy * ((s->width + 7) / 8), col);
+            break;
+        case BLIT_ALPHA4:
+            span_alpha4(dst, src, n, l->mask + sy * ((s->width + 1) / 2), col);
+            break;
+    }
+}
+
+// Topmost layer that hides everything below it on this line, or -1
+static int16_t blit_cover(const blit_layer_t *layers, uint8_t count, int16_t x0, int16_t x1, int16_t py) {
+    for (int16_t i = count - 1; i >= 0; i--) {
+        const blit_layer_t *l = &layers[i];
+        if (l->hidden || l->mode != BLIT_OPAQUE) continue;
+        if (py >= l->y && py < l->y + l->sprite->height &&
+            l->x <= x0 && l->x + l->sprite->width >= x1) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// ===== PUBLIC API =====
+
+void blit_region(const blit_layer_t *layers, uint8_t count, uint16_t background,
+                 int16_t x, int16_t y, int16_t w, int16_t h) {
+    int16_t x1 = x + w;
+    int16_t y1 = y + h;
+    if (x < 0) x = 0;
+    if (y < 0) y = 0;
+    if (x1 > TFT_WIDTH) x1 = TFT_WIDTH;
+    if (y1 > TFT_HEIGHT) y1 = TFT_HEIGHT;
+    if (x >= x1 || y >= y1) return;
+
+    uint16_t width = x1 - x;
+
+    // Lines being composited (one filling, one in flight)
+    arena_t *scratch = arena_frame();
+    arena_mark_t mark = arena_mark(scratch);
+    uint16_t *rows = arena_alloc(scratch, 2 * width * sizeof(uint16_t), ARENA_ALIGN);
+    if (!rows) return;
+
+    tft_write_begin(x, y, width, y1 - y);
+    for (int16_t py = y; py < y1; py++) {
+        // Returned from tft_write_pixels two lines ago, so it is free
+        uint16_t *buf = &rows[(py & 1) * width];
+
+        int16_t first = blit_cover(layers, count, x, x1, py);
+        if (first < 0) {
+            for (uint16_t i = 0; i < width; i++) buf[i] = background;
+            first = 0;
+        }
+
+        for (uint8_t i = first; i < count; i++) {
+            if (!layers[i].hidden) blit_layer_line(&layers[i], buf, x, x1, py);
+        }
+        tft_write_pixels(buf, width);
+    }
+    tft_write_end();
+
+    arena_release(scratch, mark);
+}
+
+void blit_move(blit_layer_t *layers, uint8_t count, uint16_t background,
+               uint8_t index, int16_t x, int16_t y) {
+    blit_layer_t *l = &layers[index];
+    int16_t ox = l->x;
+    int16_t oy = l->y;
+    int16_t w = l->sprite->width;
+    int16_t h = l->sprite->height;
+
+    l->x = x;
+    l->y = y;
+    if (l->hidden || (ox == x && oy == y)) return;
+
+    bool overlap = x < ox + w && ox < x + w && y < oy + h && oy < y + h;
+    if (overlap) {
+        int16_t ux = x < ox ? x : ox;
+        int16_t uy = y < oy ? y : oy;
+        int16_t uw = (x > ox ? x : ox) + w - ux;
+        int16_t uh = (y > oy ? y : oy) + h - uy;
+        blit_region(layers, count, background, ux, uy, uw, uh);
+    } else {
+        blit_region(layers, count, background, ox, oy, w, h);
+        blit_region(layers, count, background, x, y, w, h);
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef BLIT_H
+#define BLIT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "display.h"
+
+// How a layer's pixels combine with what is below them
+typedef enum {
+    BLIT_OPAQUE,              // Every pixel covers
+    BLIT_COLORKEY,            // Pixels equal to `key` are transparent
+    BLIT_ALPHA1,              // 1-bit mask: rows padded to a byte, MSB first
+    BLIT_ALPHA4               // 4-bit alpha: rows padded to a byte, high
+                              // nibble first (the font bitmap layout)
+} blit_mode_t;
+
+// One sprite placed on the panel. Layers are given bottom to top.
+typedef struct {
+    const sprite_t *sprite;
+    const uint8_t *mask;      // BLIT_ALPHA1 / BLIT_ALPHA4, sprite-sized
+    int16_t x;                // Panel position; may be partly off-panel
+    int16_t y;
+    uint16_t key;             // BLIT_COLORKEY
+    uint8_t mode;             // blit_mode_t
+    bool hidden;
+} blit_layer_t;
+
+// Composite the layers over a solid background for one panel rectangle
+// and stream it out a line at a time, so every pixel is sent exactly
+// once and nothing half-drawn is ever on the panel. Lines fully covered
+// by an opaque layer start from that layer instead of the background and
+// skip everything beneath it. Clipped to the panel; blocks until sent.
+void blit_region(const blit_layer_t *layers, uint8_t count, uint16_t background,
+                 int16_t x, int16_t y, int16_t w, int16_t h);
+
+// Move one layer and redraw what it uncovered and now covers: one region
+// if the old and new positions overlap, otherwise each on its own
+void blit_move(blit_layer_t *layers, uint8_t count, uint16_t background,
+               uint8_t index, int16_t x, int16_t y);
+
+#endif // BLIT_H
@@ -0,0 +1,312 @@
+#include "compositor.h"
+#include <string.h>
+
+// Differences closer than this on one row are sent as a single span; a
+// window setup costs more than re-sending a few unchanged pixels
+#define SPAN_GAP        8
+
+// Two rectangles are merged when their union wastes at most this many pixels
+#define MERGE_SLACK     128
+
+static inline int16_t min16(int16_t a, int16_t b) { return a < b ? a : b; }
+static inline int16_t max16(int16_t a, int16_t b) { return a > b ? a : b; }
+
+static int32_t rect_area(const rect_t *r) {
+    return (int32_t)r->w * r->h;
+}
+
+static rect_t rect_union(const rect_t *a, const rect_t *b) {
+    int16_t x0 = min16(a->x, b->x);
+    int16_t y0 = min16(a->y, b->y);
+    int16_t x1 = max16(a->x + a->w, b->x + b->w);
+    int16_t y1 = max16(a->y + a->h, b->y + b->h);
+    rect_t u = {x0, y0, x1 - x0, y1 - y0};
+    return u;
+}
+
+static bool rect_overlaps(const rect_t *a, const rect_t *b) {
+    return a->x < b->x + b->w && b->x < a->x + a->w &&
+           a->y < b->y + b->h && b->y < a->y + a->h;
+}
+
+// ===== DAMAGE TRACKING =====
+
+static void damage_union(damage_t *a, const damage_t *b) {
+    a->rect = rect_union(&a->rect, &b->rect);
+    a->filled += b->filled;
+}
+
+// Pixels that would be re-sent unchanged if a and b were sent as one rect
+static int32_t union_waste(const damage_t *a, const damage_t *b) {
+    rect_t u = rect_union(&a->rect, &b->rect);
+    return rect_area(&u) - (int32_t)(a->filled + b->filled);
+}
+
+static void add_span(compositor_t *comp, int16_t x0, int16_t x1, int16_t y) {
+    damage_t span = {{x0, y, x1 - x0, 1}, (uint32_t)(x1 - x0), x0, x1};
+
+    // Grow a rect whose last row is just above and lines up with this span,
+    // as long as the rect stays mostly made of changed pixels
+    for (uint8_t i = 0; i < comp->dirty_count; i++) {
+        damage_t *d = &comp->dirty[i];
+        int16_t bottom = d->rect.y + d->rect.h;
+        if (bottom < y - SPAN_GAP || bottom > y + 1) continue;
+        if (x0 > d->tail_x1 + SPAN_GAP || x1 < d->tail_x0 - SPAN_GAP) continue;
+
+        damage_t grown = *d;
+        damage_union(&grown, &span);
+        int32_t waste = rect_area(&grown.rect) - (int32_t)grown.filled;
+        if (waste > MERGE_SLACK && waste > rect_area(&grown.rect) / 4) continue;
+
+        if (bottom == y + 1) {
+            grown.tail_x0 = min16(d->tail_x0, x0);
+            grown.tail_x1 = max16(d->tail_x1, x1);
+        } else {
+            grown.tail_x0 = x0;
+            grown.tail_x1 = x1;
+        }
+        *d = grown;
+        return;
+    }
+
+    if (comp->dirty_count < COMPOSITOR_MAX_RECTS) {
+        comp->dirty[comp->dirty_count++] = span;
+        return;
+    }
+
+    // Out of slots: grow whichever rect absorbs the span most cheaply
+    uint8_t best = 0;
+    int32_t best_cost = INT32_MAX;
+    for (uint8_t i = 0; i < comp->dirty_count; i++) {
+        int32_t cost = union_waste(&comp->dirty[i], &span);
+        if (cost < best_cost) {
+            best_cost = cost;
+            best = i;
+        }
+    }
+    damage_union(&comp->dirty[best], &span);
+}
+
+// Merge rects that overlap or cost less together than a window setup
+static void merge_damage(compositor_t *comp) {
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (uint8_t i = 0; i < comp->dirty_count; i++) {
+            for (uint8_t j = i + 1; j < comp->dirty_count; j++) {
+                damage_t *a = &comp->dirty[i];
+                damage_t *b = &comp->dirty[j];
+                if (rect_overlaps(&a->rect, &b->rect) || union_waste(a, b) <= MERGE_SLACK) {
+                    damage_union(a, b);
+                    comp->dirty[j] = comp->dirty[--comp->dirty_count];
+                    merged = true;
+                    j--;
+                }
+            }
+        }
+    }
+}
+
+// Row source for one side of the diff: sprite pixels inside its
+// rectangle, the background color (stride 0) everywhere else
+typedef struct {
+    const uint16_t *row;      // Pixel at panel x = rx, or NULL off this row
+    int16_t x0;
+    int16_t x1;
+} row_src_t;
+
+static row_src_t row_source(const sprite_t *sprite, int16_t sx, int16_t sy, bool valid, int16_t py) {
+    row_src_t src = {NULL, 0, 0};
+    if (valid && py >= sy && py < sy + sprite->height) {
+        src.row = sprite->buffer + (uint32_t)(py - sy) * sprite->width;
+        src.x0 = sx;
+        src.x1 = sx + sprite->width;
+    }
+    return src;
+}
+
+static void scan_row(compositor_t *comp, int16_t py, int16_t ux0, int16_t ux1,
+                     const row_src_t *prev, const row_src_t *next) {
+    // Split the row where either source starts or stops, so each segment
+    // compares two fixed-stride streams
+    int16_t cuts[6] = {ux0, prev->x0, prev->x1, next->x0, next->x1, ux1};
+    uint8_t n = 6;
+    for (uint8_t i = 1; i < n; i++) {
+        int16_t v = cuts[i];
+        uint8_t j = i;
+        while (j > 0 && cuts[j - 1] > v) {
+            cuts[j] = cuts[j - 1];
+            j--;
+        }
+        cuts[j] = v;
+    }
+
+    const uint16_t bg = comp->background;
+    int16_t run_start = -1;
+    int16_t last_diff = -1;
+
+    for (uint8_t i = 0; i + 1 < n; i++) {
+        int16_t s = max16(cuts[i], ux0);
+        int16_t e = min16(cuts[i + 1], ux1);
+        if (s >= e) continue;
+
+        bool in_prev = prev->row && s >= prev->x0 && e <= prev->x1;
+        bool in_next = next->row && s >= next->x0 && e <= next->x1;
+        const uint16_t *pa = in_prev ? prev->row + (s - prev->x0) : &bg;
+        const uint16_t *pb = in_next ? next->row + (s - next->x0) : &bg;
+        uint8_t sa = in_prev ? 1 : 0;
+        uint8_t sb = in_next ? 1 : 0;
+
+        if (!in_prev && !in_next) continue;
+
+        for (int16_t px = s; px < e; px++, pa += sa, pb += sb) {
+            if (*pa == *pb) continue;
+
+            if (run_start >= 0 && px - last_diff > SPAN_GAP) {
+                add_span(comp, run_start, last_diff + 1, py);
+                run_start = px;
+            } else if (run_start < 0) {
+                run_start = px;
+            }
+            last_diff = px;
+        }
+    }
+
+    if (run_start >= 0) {
+        add_span(comp, run_start, last_diff + 1, py);
+    }
+}
+
+// ===== OUTPUT =====
+
+// line_buf stages composed rows, r->w pixels each (one being filled, one
+// in flight)
+static void push_rect(compositor_t *comp, const rect_t *r, int16_t nx, int16_t ny,
+                      uint16_t *line_buf) {
+    const sprite_t *sprite = comp->back;
+    int16_t sx0 = max16(r->x, nx);
+    int16_t sx1 = min16(r->x + r->w, nx + sprite->width);
+
+    tft_write_begin(r->x, r->y, r->w, r->h);
+
+    for (int16_t row = 0; row < r->h; row++) {
+        int16_t py = r->y + row;
+        uint16_t *line = &line_buf[(row & 1) * r->w];
+
+        // Compose background and sprite pixels for this row of the rect
+        if (py >= ny && py < ny + sprite->height && sx0 < sx1) {
+            for (int16_t px = r->x; px < sx0; px++) line[px - r->x] = comp->background;
+            memcpy(&line[sx0 - r->x],
+                   sprite->buffer + (uint32_t)(py - ny) * sprite->width + (sx0 - nx),
+                   (sx1 - sx0) * sizeof(uint16_t));
+            for (int16_t px = sx1; px < r->x + r->w; px++) line[px - r->x] = comp->background;
+        } else {
+            for (int16_t i = 0; i < r->w; i++) line[i] = comp->background;
+        }
+
+        tft_write_pixels(line, r->w);
+    }
+
+    tft_write_end();
+}
+
+// ===== PUBLIC API =====
+
+bool compositor_init(compositor_t *comp, uint16_t width, uint16_t height, uint16_t background) {
+    memset(comp, 0, sizeof(*comp));
+
+    comp->front = sprite_create(width, height);
+    comp->back = sprite_create(width, height);
+    if (!comp->front || !comp->back) {
+        compositor_free(comp);
+        return false;
+    }
+
+    comp->background = background;
+    sprite_fill(comp->front, background);
+    sprite_fill(comp->back, background);
+    return true;
+}
+
+void compositor_free(compositor_t *comp) {
+    sprite_free(comp->front);
+    sprite_free(comp->back);
+    comp->front = NULL;
+    comp->back = NULL;
+}
+
+void compositor_present(compositor_t *comp, int16_t x, int16_t y) {
+    const int16_t w = comp->back->width;
+    const int16_t h = comp->back->height;
+
+    // Area that can have changed: old and new sprite rects, clipped to panel
+    int16_t ux0 = x, uy0 = y, ux1 = x + w, uy1 = y + h;
+    if (comp->shown) {
+        ux0 = min16(ux0, comp->x);
+        uy0 = min16(uy0, comp->y);
+        ux1 = max16(ux1, comp->x + w);
+        uy1 = max16(uy1, comp->y + h);
+    }
+    ux0 = max16(ux0, 0);
+    uy0 = max16(uy0, 0);
+    ux1 = min16(ux1, TFT_WIDTH);
+    uy1 = min16(uy1, TFT_HEIGHT);
+
+    comp->dirty_count = 0;
+    for (int16_t py = uy0; py < uy1; py++) {
+        row_src_t prev = row_source(comp->front, comp->x, comp->y, comp->shown, py);
+        row_src_t next = row_source(comp->back, x, y, true, py);
+        scan_row(comp, py, ux0, ux1, &prev, &next);
+    }
+    merge_damage(comp);
+
+    // Without line buffers the panel keeps showing front, so leave the
+    // buffers as they are; the next present diffs against it again
+    arena_t *scratch = arena_frame();
+    arena_mark_t mark = arena_mark(scratch);
+    uint16_t *line_buf = arena_alloc(scratch, 2 * TFT_WIDTH * sizeof(uint16_t), ARENA_ALIGN);
+    if (!line_buf) {
+        comp->stats.failed++;
+        return;
+    }
+
+    // Hold the whole update back until it can land between two scans
+    if (comp->dirty_count > 0) {
+        int16_t bx0 = INT16_MAX, by0 = INT16_MAX, bx1 = INT16_MIN, by1 = INT16_MIN;
+        uint32_t area = 0;
+        for (uint8_t i = 0; i < comp->dirty_count; i++) {
+            const rect_t *r = &comp->dirty[i].rect;
+            bx0 = min16(bx0, r->x);
+            by0 = min16(by0, r->y);
+            bx1 = max16(bx1, r->x + r->w);
+            by1 = max16(by1, r->y + r->h);
+            area += rect_area(r);
+        }
+        tft_vsync_begin(bx0, by0, bx1 - bx0, by1 - by0, area);
+    }
+
+    uint32_t pushed = 0;
+    for (uint8_t i = 0; i < comp->dirty_count; i++) {
+        push_rect(comp, &comp->dirty[i].rect, x, y, line_buf);
+        pushed += rect_area(&comp->dirty[i].rect);
+    }
+    arena_release(scratch, mark);
+
+    bool moved = comp->shown && (comp->x != x || comp->y != y);
+    comp->stats.pixels_pushed = pushed;
+    comp->stats.pixels_full = (uint32_t)w * h * (moved ? 2 : 1);
+    comp->stats.rects = comp->dirty_count;
+    comp->stats.frames++;
+
+    // What was drawn is now on the panel
+    sprite_t *tmp = comp->front;
+    comp->front = comp->back;
+    comp->back = tmp;
+    comp->x = x;
+    comp->y = y;
+    comp->shown = true;
+}
+
+const compositor_stats_t* compositor_stats(const compositor_t *comp) {
+    return &comp->stats;
+}
@@ -0,0 +1,62 @@
+#ifndef COMPOSITOR_H
+#define COMPOSITOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "display.h"
+
+// Maximum damaged rectangles tracked per frame; extra damage is merged
+// into the nearest existing rectangle
+#define COMPOSITOR_MAX_RECTS 64
+
+typedef struct {
+    int16_t x;
+    int16_t y;
+    int16_t w;
+    int16_t h;
+} rect_t;
+
+// A damaged rectangle under construction
+typedef struct {
+    rect_t rect;
+    uint32_t filled;          // Pixels inside rect that actually changed
+    int16_t tail_x0;          // Changed span on the rect's last row
+    int16_t tail_x1;
+} damage_t;
+
+// Per-frame transfer counters
+typedef struct {
+    uint32_t pixels_pushed;   // Pixels actually sent for the last frame
+    uint32_t pixels_full;     // Pixels an erase-and-repush would have sent
+    uint16_t rects;           // Rectangles sent for the last frame
+    uint32_t frames;          // Frames presented since init
+    uint32_t failed;          // Presents dropped for lack of scratch memory
+} compositor_stats_t;
+
+// Double-buffered sprite on a solid background. Draw into `back`, then
+// present it; only pixels that differ from what is on the panel are sent.
+typedef struct {
+    sprite_t *front;          // Contents currently on the panel
+    sprite_t *back;           // Frame being drawn
+    int16_t x;                // Panel position of `front`
+    int16_t y;
+    bool shown;               // False until the first present
+    uint16_t background;
+
+    damage_t dirty[COMPOSITOR_MAX_RECTS];
+    uint8_t dirty_count;
+
+    compositor_stats_t stats;
+} compositor_t;
+
+bool compositor_init(compositor_t *comp, uint16_t width, uint16_t height, uint16_t background);
+void compositor_free(compositor_t *comp);
+
+// Push the damage between the panel and `back` drawn at (x, y), then swap.
+// If no line buffer can be had, nothing is sent or swapped and the same
+// damage is found again by the next present.
+void compositor_present(compositor_t *comp, int16_t x, int16_t y);
+
+const compositor_stats_t* compositor_stats(const compositor_t *comp);
+
+#endif // COMPOSITOR_H
@@ -1,64 +1,222 @@
 #include "display.h"
+#include "tft_bus.h"
 #include "pico/stdlib.h"
-#include "hardware/spi.h"
 #include "hardware/gpio.h"
-#include <stdlib.h>
+#include <stdio.h>
 #include <string.h>
 
-// Display pin definitions
-#define TFT_SPI         spi0
-#define TFT_CLK         2
-#define TFT_MOSI        3
-#define TFT_CS          5
-#define TFT_DC          6
+// Reset line; the bus pins belong to the transport (tft_bus.h)
 #define TFT_RST         7
 
+// True while a pixel data phase is open on the bus
+static volatile bool tft_dma_active = false;
+
+// Source word for solid fills; DMA reads it without incrementing
+static uint16_t tft_fill_color;
+
+// ===== DMA TRANSFER HELPERS =====
+
+static void tft_dma_start(const uint16_t *src, uint32_t count, bool increment) {
+    tft_bus_pixels_begin();
+    tft_dma_active = true;
+    tft_bus_pixels(src, count, increment);
+}
+
+static void tft_dma_finish(void) {
+    tft_bus_pixels_end();
+    tft_dma_active = false;
+}
+
+bool display_busy(void) {
+    if (!tft_dma_active) return false;
+    if (tft_bus_pixels_busy()) return true;
+
+    tft_dma_finish();
+    return false;
+}
+
+void display_wait(void) {
+    if (!tft_dma_active) return;
+
+    tft_bus_pixels_wait();
+    tft_dma_finish();
+}
+
+// ===== COMMAND BATCH =====
+
+// Window setups and short pixel runs are queued as tft_bus_batch() records
+// and sent together, so a primitive made of many small fills costs one
+// transaction per TFT_BATCH_SIZE bytes instead of several per fill
+#define TFT_BATCH_SIZE      1024
+#define TFT_BATCH_PIXELS    64      // Larger fills go straight to DMA
+
+#define TFT_CMD_SWRESET     0x01
+#define TFT_CMD_CASET       0x2A
+#define TFT_CMD_RASET       0x2B
+#define TFT_CMD_RAMWR       0x2C
+#define TFT_CMD_VSCRDEF     0x33
+#define TFT_CMD_MADCTL      0x36
+#define TFT_CMD_VSCRSADD    0x37
+#define TFT_CMD_RAMWRC      0x3C
+
+static uint8_t tft_batch_buf[TFT_BATCH_SIZE];
+static uint16_t tft_batch_len;
+static uint16_t tft_batch_record;       // Offset of the last record
+static bool tft_batch_writing;          // Last record is RAMWR/RAMWRC
+static uint8_t tft_batch_depth;
+
+// Window last sent to the panel, so unchanged CASET/RASET can be skipped
+static uint16_t tft_win_x0, tft_win_x1, tft_win_y0, tft_win_y1;
+static bool tft_win_valid = false;
+
+void tft_flush(void) {
+    if (tft_batch_len == 0) return;
+
+    display_wait();
+    tft_bus_batch(tft_batch_buf, tft_batch_len);
+    tft_batch_len = 0;
+    tft_batch_writing = false;
+}
+
+void tft_batch_begin(void) {
+    tft_batch_depth++;
+}
+
+void tft_batch_end(void) {
+    if (tft_batch_depth > 0 && --tft_batch_depth == 0) {
+        tft_flush();
+    }
+}
+
+static void tft_queue_record(uint8_t cmd, const uint8_t *params, uint16_t len) {
+    if (tft_batch_len + 3 + len > TFT_BATCH_SIZE) tft_flush();
+
+    uint8_t *rec = &tft_batch_buf[tft_batch_len];
+    rec[0] = cmd;
+    rec[1] = len & 0xFF;
+    rec[2] = len >> 8;
+    if (len) memcpy(rec + 3, params, len);
+
+    tft_batch_record = tft_batch_len;
+    tft_batch_len += 3 + len;
+    tft_batch_writing = (cmd == TFT_CMD_RAMWR || cmd == TFT_CMD_RAMWRC);
+}
+
+static void tft_queue_range(uint8_t cmd, uint16_t lo, uint16_t hi) {
+    uint8_t params[4] = {lo >> 8, lo & 0xFF, hi >> 8, hi & 0xFF};
+    tft_queue_record(cmd, params, 4);
+}
+
+void tft_queue_window(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+    if (!tft_win_valid || x0 != tft_win_x0 || x1 != tft_win_x1) {
+        tft_queue_range(TFT_CMD_CASET, x0, x1);
+    }
+    if (!tft_win_valid || y0 != tft_win_y0 || y1 != tft_win_y1) {
+        tft_queue_range(TFT_CMD_RASET, y0, y1);
+    }
+    tft_win_x0 = x0;
+    tft_win_x1 = x1;
+    tft_win_y0 = y0;
+    tft_win_y1 = y1;
+    tft_win_valid = true;
+
+    // RAMWR always restarts at the window origin, even when it is unchanged
+    tft_queue_record(TFT_CMD_RAMWR, NULL, 0);
+}
+
+void tft_queue_pixels(uint16_t color, uint32_t count) {
+    while (count > 0) {
+        // A run split by a flush carries on where the panel left off
+        if (!tft_batch_writing || tft_batch_len + 2 > TFT_BATCH_SIZE) {
+            if (tft_batch_len + 5 > TFT_BATCH_SIZE) tft_flush();
+            tft_queue_record(TFT_CMD_RAMWRC, NULL, 0);
+        }
+
+        uint32_t n = (TFT_BATCH_SIZE - tft_batch_len) / 2;
+        if (n > count) n = count;
+
+        uint8_t *rec = &tft_batch_buf[tft_batch_record];
+        uint16_t len = (rec[1] | (rec[2] << 8)) + n * 2;
+        rec[1] = len & 0xFF;
+        rec[2] = len >> 8;
+
+        uint8_t *dst = &tft_batch_buf[tft_batch_len];
+        for (uint32_t i = 0; i < n; i++) {
+            *dst++ = color >> 8;
+            *dst++ = color & 0xFF;
+        }
+        tft_batch_len += n * 2;
+        count -= n;
+    }
+}
+
+// ===== LOW-LEVEL COMMANDS =====
+
 void tft_write_command(uint8_t cmd) {
-    gpio_put(TFT_DC, 0);
-    gpio_put(TFT_CS, 0);
-    spi_write_blocking(TFT_SPI, &cmd, 1);
-    gpio_put(TFT_CS, 1);
+    tft_flush();
+    display_wait();
+
+    // Writes that bypass the queue may move or reset the panel's window
+    if (cmd == TFT_CMD_CASET || cmd == TFT_CMD_RASET ||
+        cmd == TFT_CMD_SWRESET || cmd == TFT_CMD_MADCTL) {
+        tft_win_valid = false;
+    }
+    tft_bus_command(cmd);
 }
 
 void tft_write_data(uint8_t data) {
-    gpio_put(TFT_DC, 1);
-    gpio_put(TFT_CS, 0);
-    spi_write_blocking(TFT_SPI, &data, 1);
-    gpio_put(TFT_CS, 1);
+    tft_flush();
+    display_wait();
+    tft_bus_data(&data, 1);
 }
 
 void tft_write_data16(uint16_t data) {
     uint8_t buf[2] = {data >> 8, data & 0xFF};
-    gpio_put(TFT_DC, 1);
-    gpio_put(TFT_CS, 0);
-    spi_write_blocking(TFT_SPI, buf, 2);
-    gpio_put(TFT_CS, 1);
+    tft_flush();
+    display_wait();
+    tft_bus_data(buf, 2);
 }
 
 void tft_set_window(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
-    tft_write_command(0x2A); // Column address set
-    tft_write_data16(x0);
-    tft_write_data16(x1);
-
-    tft_write_command(0x2B); // Row address set
-    tft_write_data16(y0);
-    tft_write_data16(y1);
-
-    tft_write_command(0x2C); // Memory write
+    tft_queue_window(x0, y0, x1, y1);
+    tft_flush();
 }
 
 void tft_fill_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color) {
+    uint32_t count = (uint32_t)w * h;
+
+    // Small fills ride in the batch; inside tft_batch_begin/end they
+    // coalesce with their neighbours into one transaction
+    if (count <= TFT_BATCH_PIXELS) {
+        tft_queue_window(x, y, x + w - 1, y + h - 1);
+        tft_queue_pixels(color, count);
+        if (tft_batch_depth == 0) tft_flush();
+        return;
+    }
+
     tft_set_window(x, y, x + w - 1, y + h - 1);
 
-    gpio_put(TFT_DC, 1);
-    gpio_put(TFT_CS, 0);
+    // Repeat a single source word for the whole rectangle
+    tft_fill_color = color;
+    tft_dma_start(&tft_fill_color, count, false);
+    display_wait();
+}
 
-    uint8_t buf[2] = {color >> 8, color & 0xFF};
-    for (uint32_t i = 0; i < w * h; i++) {
-        spi_write_blocking(TFT_SPI, buf, 2);
-    }
+void tft_write_begin(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    tft_set_window(x, y, x + w - 1, y + h - 1);
+    tft_bus_pixels_begin();
+    tft_dma_active = true;
+}
+
+void tft_write_pixels(const uint16_t *pixels, uint32_t count) {
+    // Only one run is queued at a time; the caller may refill the
+    // previous run's buffer once this returns
+    tft_bus_pixels_wait();
+    tft_bus_pixels(pixels, count, true);
+}
 
-    gpio_put(TFT_CS, 1);
+void tft_write_end(void) {
+    display_wait();
 }
 
 void tft_draw_circle(uint16_t x0, uint16_t y0, uint16_t r, uint16_t color) {
@@ -68,7 +226,9 @@ void tft_draw_circle(uint16_t x0, uint16_t y0, uint16_t r, uint16_t color) {
     int16_t x = 0;
     int16_t y = r;
 
-    // Draw circle using Bresenham's algorithm
+    // Draw circle using Bresenham's algorithm; the 1x1 fills are queued
+    // and go out in a handful of batched transactions
+    tft_batch_begin();
     while (x < y) {
         if (f >= 0) {
             y--;
@@ -89,6 +249,7 @@ void tft_draw_circle(uint16_t x0, uint16_t y0, uint16_t r, uint16_t color) {
         tft_fill_rect(x0 + y, y0 - x, 1, 1, color);
         tft_fill_rect(x0 - y, y0 - x, 1, 1, color);
     }
+    tft_batch_end();
 }
 
 void tft_fill_circle(uint16_t x0, uint16_t y0, uint16_t r, uint16_t color) {
@@ -98,6 +259,8 @@ void tft_fill_circle(uint16_t x0, uint16_t y0, uint16_t r, uint16_t color) {
     int16_t x = 0;
     int16_t y = r;
 
+    // Short spans are batched; long ones flush the queue and use DMA
+    tft_batch_begin();
     tft_fill_rect(x0 - r, y0, 2 * r + 1, 1, color);
 
     while (x < y) {
@@ -115,110 +278,116 @@ void tft_fill_circle(uint16_t x0, uint16_t y0, uint16_t r, uint16_t color) {
         tft_fill_rect(x0 - y, y0 + x, 2 * y + 1, 1, color);
         tft_fill_rect(x0 - y, y0 - x, 2 * y + 1, 1, color);
     }
+    tft_batch_end();
 }
 
 // ===== SPRITE BUFFER FUNCTIONS =====
 
 sprite_t* sprite_create(uint16_t width, uint16_t height) {
-    sprite_t *sprite = malloc(sizeof(sprite_t));
-    if (!sprite) return NULL;
+    return sprite_create_in(&arena_static, width, height);
+}
+
+sprite_t* sprite_create_in(arena_t *arena, uint16_t width, uint16_t height) {
+    // The header is padded so the pixels that follow stay aligned
+    uint32_t header = (sizeof(sprite_t) + ARENA_ALIGN - 1) & ~(uint32_t)(ARENA_ALIGN - 1);
+    uint8_t *block = arena_alloc(arena, header + (uint32_t)width * height * sizeof(uint16_t),
+                                 ARENA_ALIGN);
+    if (!block) return NULL;
 
+    sprite_t *sprite = (sprite_t *)block;
+    sprite->buffer = (uint16_t *)(block + header);
     sprite->width = width;
     sprite->height = height;
-    sprite->buffer = malloc(width * height * sizeof(uint16_t));
-
-    if (!sprite->buffer) {
-        free(sprite);
-        return NULL;
-    }
-
+    sprite->arena = arena;
     return sprite;
 }
 
 void sprite_free(sprite_t *sprite) {
-    if (sprite) {
-        if (sprite->buffer) free(sprite->buffer);
-        free(sprite);
+    if (sprite && sprite->arena) {
+        arena_pop(sprite->arena, sprite);
     }
 }
 
-void sprite_fill(sprite_t *sprite, uint16_t color) {
-    for (uint32_t i = 0; i < sprite->width * sprite->height; i++) {
-        sprite->buffer[i] = color;
-    }
+void sprite_push_start(sprite_t *sprite, uint16_t x, uint16_t y) {
+    tft_set_window(x, y, x + sprite->width - 1, y + sprite->height - 1);
+
+    // Stream the whole buffer in one transfer; the sprite must not be
+    // modified until display_busy() reports the push complete
+    tft_dma_start(sprite->buffer, (uint32_t)sprite->width * sprite->height, true);
 }
 
-void sprite_fill_circle(sprite_t *sprite, int16_t x0, int16_t y0, uint16_t r, uint16_t color) {
-    int16_t f = 1 - r;
-    int16_t ddF_x = 1;
-    int16_t ddF_y = -2 * r;
-    int16_t x = 0;
-    int16_t y = r;
+void sprite_push(sprite_t *sprite, uint16_t x, uint16_t y) {
+    sprite_push_start(sprite, x, y);
+    display_wait();
+}
 
-    // Helper to set pixel in sprite buffer
-    auto void set_pixel(int16_t px, int16_t py) {
-        if (px >= 0 && px < sprite->width && py >= 0 && py < sprite->height) {
-            sprite->buffer[py * sprite->width + px] = color;
-        }
-    }
+// ===== ORIENTATION AND SCROLLING =====
+
+#define MADCTL_MY           0x80
+#define MADCTL_MX           0x40
+#define MADCTL_MV           0x20
+
+// MADCTL per tft_rotation_t: row/column exchange and mirroring only
+static const uint8_t tft_madctl[4] = {
+    0,
+    MADCTL_MV | MADCTL_MX,
+    MADCTL_MX | MADCTL_MY,
+    MADCTL_MV | MADCTL_MY,
+};
+
+static uint8_t tft_rotation_now = TFT_ROTATION;
+static uint16_t tft_scroll_top = 0;
+static uint16_t tft_scroll_height = TFT_PANEL_HEIGHT;
+static uint16_t tft_scroll_offset = 0;
+
+bool tft_set_rotation(uint8_t rotation) {
+    // TFT_WIDTH/TFT_HEIGHT are fixed at build time, so only turns that
+    // keep the aspect are allowed
+    if (rotation > TFT_ROTATE_270 || (rotation & 1) != (TFT_ROTATION & 1)) return false;
+
+    uint8_t madctl = tft_madctl[rotation];
+    tft_queue_record(TFT_CMD_MADCTL, &madctl, 1);
+    tft_win_valid = false;
+    if (tft_batch_depth == 0) tft_flush();
+
+    tft_rotation_now = rotation;
+    return true;
+}
 
-    // Fill horizontal line
-    for (int16_t i = x0 - r; i <= x0 + r; i++) {
-        set_pixel(i, y0);
-    }
+uint8_t tft_rotation(void) {
+    return tft_rotation_now;
+}
 
-    while (x < y) {
-        if (f >= 0) {
-            y--;
-            ddF_y += 2;
-            f += ddF_y;
-        }
-        x++;
-        ddF_x += 2;
-        f += ddF_x;
+void tft_scroll_define(uint16_t top, uint16_t bottom) {
+    if (top + bottom >= TFT_PANEL_HEIGHT) return;
 
-        // Fill horizontal lines for filled circle
-        for (int16_t i = x0 - x; i <= x0 + x; i++) {
-            set_pixel(i, y0 + y);
-            set_pixel(i, y0 - y);
-        }
-        for (int16_t i = x0 - y; i <= x0 + y; i++) {
-            set_pixel(i, y0 + x);
-            set_pixel(i, y0 - x);
-        }
-    }
-}
+    tft_scroll_top = top;
+    tft_scroll_height = TFT_PANEL_HEIGHT - top - bottom;
 
-void sprite_push(sprite_t *sprite, uint16_t x, uint16_t y) {
-    tft_set_window(x, y, x + sprite->width - 1, y + sprite->height - 1);
+    uint16_t h = tft_scroll_height;
+    uint8_t params[6] = {top >> 8, top & 0xFF, h >> 8, h & 0xFF, bottom >> 8, bottom & 0xFF};
+    tft_queue_record(TFT_CMD_VSCRDEF, params, sizeof(params));
+    tft_scroll_to(0);
+}
 
-    gpio_put(TFT_DC, 1);
-    gpio_put(TFT_CS, 0);
+void tft_scroll_to(uint16_t offset) {
+    tft_scroll_offset = offset % tft_scroll_height;
 
-    // Send sprite buffer to display
-    for (uint32_t i = 0; i < sprite->width * sprite->height; i++) {
-        uint8_t buf[2] = {sprite->buffer[i] >> 8, sprite->buffer[i] & 0xFF};
-        spi_write_blocking(TFT_SPI, buf, 2);
-    }
+    uint16_t start = tft_scroll_top + tft_scroll_offset;
+    uint8_t params[2] = {start >> 8, start & 0xFF};
+    tft_queue_record(TFT_CMD_VSCRSADD, params, sizeof(params));
+    if (tft_batch_depth == 0) tft_flush();
+}
 
-    gpio_put(TFT_CS, 1);
+uint16_t tft_scroll_row(uint16_t line) {
+    return tft_scroll_top + (tft_scroll_offset + line) % tft_scroll_height;
 }
 
 // ===== DISPLAY INITIALIZATION =====
 
 void display_init(void) {
-    // Initialize SPI for display
-    spi_init(TFT_SPI, 62500 * 1000); // 62.5 MHz
-    gpio_set_function(TFT_CLK, GPIO_FUNC_SPI);
-    gpio_set_function(TFT_MOSI, GPIO_FUNC_SPI);
-
-    // CS, DC, RST as outputs
-    gpio_init(TFT_CS);
-    gpio_set_dir(TFT_CS, GPIO_OUT);
-    gpio_put(TFT_CS, 1);
-
-    gpio_init(TFT_DC);
-    gpio_set_dir(TFT_DC, GPIO_OUT);
+    // Bus pins, peripheral and DMA channel
+    tft_bus_init();
 
     gpio_init(TFT_RST);
     gpio_set_dir(TFT_RST, GPIO_OUT);
@@ -240,5 +409,53 @@ void display_init(void) {
     tft_write_command(0x3A); // Pixel format
     tft_write_data(0x55);    // 16-bit color
 
+    tft_set_rotation(TFT_ROTATION);
+    tft_vsync_init();
+
     tft_write_command(0x29); // Display on
 }
+
+// ===== TRANSPORT BENCHMARK =====
+
+void display_benchmark(void) {
+    const uint16_t runs = 20;
+    uint64_t t0, t1;
+
+    printf("Display benchmark (%s transport)\n", tft_bus_name);
+
+    // Full-screen solid fills: pure pixel throughput
+    t0 = time_us_64();
+    for (uint16_t i = 0; i < runs; i++) {
+        tft_fill_rect(0, 0, TFT_WIDTH, TFT_HEIGHT, i & 1 ? COLOR_BLACK : COLOR_WHITE);
+    }
+    t1 = time_us_64();
+    uint32_t fill_us = (uint32_t)((t1 - t0) / runs);
+    printf("  Fill %ux%u:    %lu us, %lu kpx/s\n", TFT_WIDTH, TFT_HEIGHT, (unsigned long)fill_us,
+           (unsigned long)((uint64_t)TFT_WIDTH * TFT_HEIGHT * 1000 / fill_us));
+
+    // Sprite pushes from memory
+    sprite_t *sprite = sprite_create(220, 220);
+    if (sprite) {
+        sprite_fill(sprite, COLOR_BLUE);
+        t0 = time_us_64();
+        for (uint16_t i = 0; i < runs; i++) {
+            sprite_push(sprite, 50, 130);
+        }
+        t1 = time_us_64();
+        uint32_t push_us = (uint32_t)((t1 - t0) / runs);
+        printf("  Push 220x220:    %lu us, %lu kpx/s\n", (unsigned long)push_us,
+               (unsigned long)((uint64_t)220 * 220 * 1000 / push_us));
+        sprite_free(sprite);
+    }
+
+    // Command overhead: window setup dominates small updates. The window
+    // moves every time so the cache cannot skip CASET and RASET.
+    t0 = time_us_64();
+    for (uint16_t i = 0; i < runs * 50; i++) {
+        tft_set_window(i & 1, i & 1, TFT_WIDTH - 1, TFT_HEIGHT - 1);
+    }
+    t1 = time_us_64();
+    printf("  Set window:      %lu ns\n", (unsigned long)((t1 - t0) * 1000 / (runs * 50)));
+
+    tft_fill_rect(0, 0, TFT_WIDTH, TFT_HEIGHT, COLOR_WHITE);
+}
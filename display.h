@@ -3,10 +3,32 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "font.h"
+#include "arena.h"
 
-// Display dimensions
-#define TFT_WIDTH  320
-#define TFT_HEIGHT 480
+// Panel memory, portrait, as the controller stores it
+#define TFT_PANEL_WIDTH  320
+#define TFT_PANEL_HEIGHT 480
+
+// Orientations, as turns of the image clockwise from the panel's own
+typedef enum {
+    TFT_ROTATE_0,
+    TFT_ROTATE_90,
+    TFT_ROTATE_180,
+    TFT_ROTATE_270
+} tft_rotation_t;
+
+// Display dimensions, in the build's orientation: portrait unless built
+// with TFT_LANDSCAPE (-DLIL_GUY_LANDSCAPE=ON)
+#ifdef TFT_LANDSCAPE
+#define TFT_WIDTH    TFT_PANEL_HEIGHT
+#define TFT_HEIGHT   TFT_PANEL_WIDTH
+#define TFT_ROTATION TFT_ROTATE_90
+#else
+#define TFT_WIDTH    TFT_PANEL_WIDTH
+#define TFT_HEIGHT   TFT_PANEL_HEIGHT
+#define TFT_ROTATION TFT_ROTATE_0
+#endif
 
 // Colors (RGB565 format)
 #define COLOR_BLACK   0x0000
@@ -25,6 +47,48 @@ void tft_write_data(uint8_t data);
 void tft_write_data16(uint16_t data);
 void tft_set_window(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
 
+// Orientation through MADCTL: the controller maps coordinates, so a turn
+// costs one register write and nothing is re-sent. Only turns with the
+// build's aspect are accepted (0/180 in portrait, 90/270 in landscape);
+// returns false otherwise. Drawn content stays put, the next writes land
+// in the new orientation.
+bool tft_set_rotation(uint8_t rotation);
+uint8_t tft_rotation(void);
+
+// Hardware vertical scrolling (VSCRDEF/VSCRSADD). The panel shows its
+// memory rows between the fixed top and bottom bands starting from a
+// movable row, wrapping around, so scrolling a playfield costs one
+// register write plus drawing the rows that come into view.
+//
+// Rows are panel memory rows along the 480-pixel axis: y in portrait,
+// x in landscape (counted from the other edge at 180/270 degrees).
+void tft_scroll_define(uint16_t top, uint16_t bottom);
+
+// Show the scroll area starting offset rows in (wraps)
+void tft_scroll_to(uint16_t offset);
+
+// Memory row shown at line `line` of the scroll area right now; draw
+// there to fill in what scrolled into view
+uint16_t tft_scroll_row(uint16_t line);
+
+// Command batch: window setups and solid pixel runs are queued and sent
+// as one transaction, skipping CASET/RASET when the window is unchanged.
+// The queue is flushed when full, before any other bus access, and by
+// tft_flush(). Between tft_batch_begin() and tft_batch_end() small
+// tft_fill_rect() calls are queued instead of being sent one by one.
+void tft_queue_window(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
+void tft_queue_pixels(uint16_t color, uint32_t count);
+void tft_flush(void);
+void tft_batch_begin(void);
+void tft_batch_end(void);
+
+// Streamed window writes: open a window, feed it pixel runs, close it.
+// Each run is sent by DMA, so its buffer must stay valid until the next
+// tft_write_pixels() or tft_write_end() call returns.
+void tft_write_begin(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+void tft_write_pixels(const uint16_t *pixels, uint32_t count);
+void tft_write_end(void);
+
 // Drawing primitives
 void tft_fill_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color);
 void tft_draw_circle(uint16_t x0, uint16_t y0, uint16_t r, uint16_t color);
@@ -35,15 +99,159 @@ typedef struct {
     uint16_t *buffer;
     uint16_t width;
     uint16_t height;
+    arena_t *arena;           // Where it was created, NULL for wrapped buffers
 } sprite_t;
 
+// Header and pixels in one block from an arena, buffer DMA-aligned.
+// sprite_create() uses arena_static. Freeing only returns the memory if
+// the sprite was the arena's latest allocation; otherwise it goes back
+// when the arena is released to a mark from before it was created.
 sprite_t* sprite_create(uint16_t width, uint16_t height);
+sprite_t* sprite_create_in(arena_t *arena, uint16_t width, uint16_t height);
 void sprite_free(sprite_t *sprite);
+void sprite_push(sprite_t *sprite, uint16_t x, uint16_t y);
+
+// Asynchronous push: starts a DMA transfer and returns immediately.
+// Leave the sprite untouched until display_busy() returns false.
+void sprite_push_start(sprite_t *sprite, uint16_t x, uint16_t y);
+
+// Transfer status (display_busy also closes a finished transfer)
+bool display_busy(void);
+void display_wait(void);
+
+// Sprite rasterizer (raster.c). Shapes are clipped to the sprite and
+// drawn as horizontal spans.
 void sprite_fill(sprite_t *sprite, uint16_t color);
+void sprite_hspan(sprite_t *sprite, int16_t x0, int16_t x1, int16_t y, uint16_t color);
+void sprite_fill_rect(sprite_t *sprite, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
 void sprite_fill_circle(sprite_t *sprite, int16_t x0, int16_t y0, uint16_t r, uint16_t color);
-void sprite_push(sprite_t *sprite, uint16_t x, uint16_t y);
+void sprite_fill_round_rect(sprite_t *sprite, int16_t x, int16_t y, int16_t w, int16_t h,
+                            uint16_t r, uint16_t color);
+void sprite_fill_triangle(sprite_t *sprite, int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                          int16_t x2, int16_t y2, uint16_t color);
+void sprite_draw_line(sprite_t *sprite, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+
+// Anti-aliased variants blend edges into what is already in the sprite
+void sprite_fill_circle_aa(sprite_t *sprite, int16_t x0, int16_t y0, uint16_t r, uint16_t color);
+void sprite_draw_line_aa(sprite_t *sprite, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+
+// Blend fg over bg with 8-bit alpha, all three channels in one multiply
+static inline uint16_t blend565(uint16_t fg, uint16_t bg, uint8_t alpha) {
+    uint32_t a = (alpha + 4) >> 3; // 0..32
+    uint32_t f = (fg | ((uint32_t)fg << 16)) & 0x07E0F81F;
+    uint32_t b = (bg | ((uint32_t)bg << 16)) & 0x07E0F81F;
+    uint32_t r = (b + (((f - b) * a) >> 5)) & 0x07E0F81F;
+    return (uint16_t)(r | (r >> 16));
+}
+
+// Text (text.c), in fonts from the asset pipeline. Each byte of a string
+// is one code point; ones the font lacks are drawn as '?'. Text is placed
+// by the top-left corner of its line box (line_height tall, baseline at
+// ascent).
+const font_glyph_t* font_glyph(const font_t *font, uint8_t code);
+uint16_t text_width(const font_t *font, const char *text);
+
+// Antialiased, blended over the sprite's contents and clipped to it
+void sprite_draw_text(sprite_t *sprite, const font_t *font, int16_t x, int16_t y,
+                      const char *text, uint16_t color);
+
+// Straight to the panel as one window over a solid background, streamed a
+// row at a time; clipped to the panel. Returns the width drawn.
+uint16_t tft_draw_text(uint16_t x, uint16_t y, const font_t *font, const char *text,
+                       uint16_t fg, uint16_t bg);
+
+// A line of text kept on the panel, for HUDs and counters. Setting new
+// text re-sends only from the first glyph that changed, and nothing at
+// all when the text is the same.
+#define TEXT_RUN_MAX 47
+
+typedef struct {
+    const font_t *font;
+    uint16_t x;
+    uint16_t y;
+    uint16_t fg;
+    uint16_t bg;
+    uint16_t width;           // Extent currently on the panel
+    bool drawn;
+    char text[TEXT_RUN_MAX + 1];
+} text_run_t;
+
+void text_run_init(text_run_t *run, const font_t *font, uint16_t x, uint16_t y,
+                   uint16_t fg, uint16_t bg);
+void text_run_set(text_run_t *run, const char *text);
+
+// The panel under the run was overwritten; the next set redraws it all
+void text_run_invalidate(text_run_t *run);
+
+// Palette-indexed sprites (sprite_fmt.c). Pixels are indices into an
+// RGB565 palette and are expanded on the fly while pushing, so a sprite
+// costs 1-8 bits per pixel and recoloring it is a palette change. The
+// data is const, so images compiled into the firmware stay in flash.
+//
+// Packed formats hold rows top to bottom, each padded to a whole byte,
+// with the leftmost pixel in the most significant bits. SPRITE_RLE8 is
+// one continuous stream of 8-bit indices in control-byte runs:
+//   0x00-0x7F  n + 1 literal indices follow
+//   0x80-0xFF  the next index repeats (n & 0x7F) + 1 times
+// Runs may span rows.
+typedef enum {
+    SPRITE_INDEX1,
+    SPRITE_INDEX2,
+    SPRITE_INDEX4,
+    SPRITE_INDEX8,
+    SPRITE_RLE8
+} sprite_format_t;
+
+typedef struct {
+    const uint8_t *data;
+    const uint16_t *palette;  // 2^bpp entries (256 for SPRITE_RLE8)
+    uint16_t width;
+    uint16_t height;
+    uint8_t format;           // sprite_format_t
+} indexed_sprite_t;
+
+// Bytes of pixel data a packed format needs (0 for SPRITE_RLE8)
+uint32_t indexed_sprite_size(uint8_t format, uint16_t width, uint16_t height);
+
+// Expand through the palette straight to the panel, streaming small
+// chunks; blocks until the last chunk is sent
+void indexed_sprite_push(const indexed_sprite_t *sprite, uint16_t x, uint16_t y);
+
+// Expand into an RGB565 sprite at (x, y), clipped to it
+void indexed_sprite_draw(const indexed_sprite_t *sprite, sprite_t *dst, int16_t x, int16_t y);
+
+// Tear-free presentation (vsync.c). With the panel's TE output wired to
+// GPIO TFT_TE (-DLIL_GUY_TFT_TE=<gpio>), the controller pulses it after
+// every refresh and the pulses track where its scan is. The ST7796 bus is
+// write-only here, so without TE there is no scan position to go on and
+// writes go out at once, tearing as before.
+typedef struct {
+    uint32_t vsyncs;          // TE pulses seen
+    uint32_t period_us;       // Measured refresh period
+    uint32_t presents;
+    uint32_t torn;            // Presents too big to fit between two scans
+    uint32_t wait_us;         // Time the last present was held back
+    uint32_t cadence[4];      // Presents 1, 2, 3 and 4+ refreshes apart
+} tft_vsync_stats_t;
+
+// Enable TE output and its interrupt (display_init calls this)
+void tft_vsync_init(void);
+
+// True once the refresh period is known
+bool tft_vsync_enabled(void);
+
+// Call before writing a rectangle of `pixels` pixels (at most the area of
+// x, y, w, h). Waits until the scan has left those rows with enough of the
+// refresh left to finish before it comes back round, at most one period.
+void tft_vsync_begin(int16_t x, int16_t y, int16_t w, int16_t h, uint32_t pixels);
+
+const tft_vsync_stats_t* tft_vsync_stats(void);
 
 // Initialization
 void display_init(void);
 
+// Time fills, sprite pushes and window setup on the compiled-in transport
+// and print the results (clears the screen)
+void display_benchmark(void);
+
 #endif // DISPLAY_H
@@ -0,0 +1,281 @@
+#include "displaylist.h"
+#include "fixed.h"
+#include <string.h>
+
+// Two RGB565 pixels; may_alias lets it overlay the uint16_t buffer
+typedef uint32_t __attribute__((may_alias)) pixel_pair_t;
+
+// ===== RECORDING =====
+
+static void invalidate(display_list_t *dl) {
+    dl->cache_valid = false;
+    dl->stamp++;
+}
+
+static bool record(display_list_t *dl, uint8_t op, uint8_t color,
+                   int16_t a0, int16_t a1, int16_t a2, int16_t a3, int16_t a4, int16_t a5) {
+    if (dl->count >= dl->capacity) return false;
+
+    display_list_cmd_t *cmd = &dl->cmds[dl->count++];
+    cmd->op = op;
+    cmd->color = color;
+    cmd->args[0] = a0;
+    cmd->args[1] = a1;
+    cmd->args[2] = a2;
+    cmd->args[3] = a3;
+    cmd->args[4] = a4;
+    cmd->args[5] = a5;
+    invalidate(dl);
+    return true;
+}
+
+bool display_list_init(display_list_t *dl, uint16_t width, uint16_t height, uint16_t capacity) {
+    memset(dl, 0, sizeof(*dl));
+
+    // The index cache is only allocated once the list is drawn into a
+    // sprite, so scenes that are only rendered in tiles never pay for it
+    dl->arena = &arena_static;
+    dl->cmds = arena_alloc(dl->arena, capacity * sizeof(display_list_cmd_t), ARENA_ALIGN);
+    if (!dl->cmds) return false;
+
+    dl->capacity = capacity;
+    dl->width = width;
+    dl->height = height;
+    return true;
+}
+
+void display_list_free(display_list_t *dl) {
+    if (dl->cache) arena_pop(dl->arena, dl->cache);
+    if (dl->cmds) arena_pop(dl->arena, dl->cmds);
+    dl->cmds = NULL;
+    dl->cache = NULL;
+}
+
+void display_list_clear(display_list_t *dl) {
+    dl->count = 0;
+    invalidate(dl);
+}
+
+bool display_list_fill(display_list_t *dl, uint8_t color) {
+    return record(dl, DL_FILL, color, 0, 0, 0, 0, 0, 0);
+}
+
+bool display_list_rect(display_list_t *dl, int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color) {
+    return record(dl, DL_RECT, color, x, y, w, h, 0, 0);
+}
+
+bool display_list_round_rect(display_list_t *dl, int16_t x, int16_t y, int16_t w, int16_t h,
+                             int16_t r, uint8_t color) {
+    return record(dl, DL_ROUND_RECT, color, x, y, w, h, r, 0);
+}
+
+bool display_list_circle(display_list_t *dl, int16_t x, int16_t y, int16_t r, uint8_t color) {
+    return record(dl, DL_CIRCLE, color, x, y, r, 0, 0, 0);
+}
+
+bool display_list_triangle(display_list_t *dl, int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                           int16_t x2, int16_t y2, uint8_t color) {
+    return record(dl, DL_TRIANGLE, color, x0, y0, x1, y1, x2, y2);
+}
+
+bool display_list_line(display_list_t *dl, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t color) {
+    return record(dl, DL_LINE, color, x0, y0, x1, y1, 0, 0);
+}
+
+bool display_list_arc_dots(display_list_t *dl, int16_t cx, int16_t cy, int16_t radius,
+                           int16_t start_deg, int16_t end_deg, int16_t step_deg,
+                           int16_t dot_r, uint8_t color) {
+    if (step_deg < 1) step_deg = 1;
+
+    for (int16_t deg = start_deg; deg <= end_deg; deg += step_deg) {
+        int16_t x = cx + q15_scale(fx_cos_deg(deg), radius);
+        int16_t y = cy + q15_scale(fx_sin_deg(deg), radius);
+        if (!display_list_circle(dl, x, y, dot_r, color)) return false;
+    }
+    return true;
+}
+
+void display_list_set_color(display_list_t *dl, uint8_t index, uint16_t color) {
+    if (index >= DISPLAY_LIST_COLORS || dl->palette[index] == color) return;
+
+    // The raster stays valid; only the expansion is stale
+    dl->palette[index] = color;
+    dl->stamp++;
+}
+
+// ===== REPLAY =====
+
+static inline int16_t min3(int16_t a, int16_t b, int16_t c) {
+    int16_t m = a < b ? a : b;
+    return m < c ? m : c;
+}
+
+static inline int16_t max3(int16_t a, int16_t b, int16_t c) {
+    int16_t m = a > b ? a : b;
+    return m > c ? m : c;
+}
+
+// Bounding box of a command in scene coordinates, inclusive
+static void cmd_bounds(const display_list_cmd_t *cmd, int16_t *x0, int16_t *y0,
+                       int16_t *x1, int16_t *y1) {
+    const int16_t *a = cmd->args;
+
+    switch (cmd->op) {
+        case DL_RECT:
+        case DL_ROUND_RECT:
+            *x0 = a[0];
+            *y0 = a[1];
+            *x1 = a[0] + a[2] - 1;
+            *y1 = a[1] + a[3] - 1;
+            break;
+        case DL_CIRCLE:
+            *x0 = a[0] - a[2];
+            *y0 = a[1] - a[2];
+            *x1 = a[0] + a[2];
+            *y1 = a[1] + a[2];
+            break;
+        case DL_TRIANGLE:
+            *x0 = min3(a[0], a[2], a[4]);
+            *y0 = min3(a[1], a[3], a[5]);
+            *x1 = max3(a[0], a[2], a[4]);
+            *y1 = max3(a[1], a[3], a[5]);
+            break;
+        case DL_LINE:
+            *x0 = a[0] < a[2] ? a[0] : a[2];
+            *y0 = a[1] < a[3] ? a[1] : a[3];
+            *x1 = a[0] > a[2] ? a[0] : a[2];
+            *y1 = a[1] > a[3] ? a[1] : a[3];
+            break;
+        default: // DL_FILL covers everything
+            *x0 = INT16_MIN;
+            *y0 = INT16_MIN;
+            *x1 = INT16_MAX;
+            *y1 = INT16_MAX;
+            break;
+    }
+}
+
+// Draw the scene into the sprite with scene point (dx, dy) at the sprite's
+// origin. Colors come from `colors`, or are the raw palette indices when
+// it is NULL. Commands entirely outside the sprite are skipped.
+static void replay(const display_list_t *dl, sprite_t *sprite, int16_t dx, int16_t dy,
+                   const uint16_t *colors) {
+    for (uint16_t i = 0; i < dl->count; i++) {
+        const display_list_cmd_t *cmd = &dl->cmds[i];
+        const int16_t *a = cmd->args;
+        uint16_t color = colors ? colors[cmd->color & (DISPLAY_LIST_COLORS - 1)] : cmd->color;
+
+        int16_t x0, y0, x1, y1;
+        cmd_bounds(cmd, &x0, &y0, &x1, &y1);
+        if (x1 < dx || y1 < dy || x0 >= dx + sprite->width || y0 >= dy + sprite->height) continue;
+
+        switch (cmd->op) {
+            case DL_FILL:
+                sprite_fill(sprite, color);
+                break;
+            case DL_RECT:
+                sprite_fill_rect(sprite, a[0] - dx, a[1] - dy, a[2], a[3], color);
+                break;
+            case DL_ROUND_RECT:
+                sprite_fill_round_rect(sprite, a[0] - dx, a[1] - dy, a[2], a[3], a[4], color);
+                break;
+            case DL_CIRCLE:
+                sprite_fill_circle(sprite, a[0] - dx, a[1] - dy, a[2], color);
+                break;
+            case DL_TRIANGLE:
+                sprite_fill_triangle(sprite, a[0] - dx, a[1] - dy, a[2] - dx, a[3] - dy,
+                                     a[4] - dx, a[5] - dy, color);
+                break;
+            case DL_LINE:
+                sprite_draw_line(sprite, a[0] - dx, a[1] - dy, a[2] - dx, a[3] - dy, color);
+                break;
+        }
+    }
+}
+
+void display_list_render(const display_list_t *dl, sprite_t *sprite, int16_t x, int16_t y) {
+    replay(dl, sprite, x, y, dl->palette);
+}
+
+// ===== RASTER CACHE =====
+
+// Replay the scene into the sprite with palette indices as colors, then
+// keep the low bytes. The sprite is about to be overwritten anyway, so
+// it doubles as the 16-bit scratch buffer.
+static void rasterize(display_list_t *dl, sprite_t *sprite) {
+    replay(dl, sprite, 0, 0, NULL);
+
+    uint32_t n = (uint32_t)dl->width * dl->height;
+    for (uint32_t i = 0; i < n; i++) {
+        dl->cache[i] = (uint8_t)sprite->buffer[i];
+    }
+    dl->cache_valid = true;
+}
+
+// Palette lookup over the cached indices, two pixels per store
+static void expand(const display_list_t *dl, sprite_t *sprite) {
+    const uint8_t *src = dl->cache;
+    const uint16_t *pal = dl->palette;
+    pixel_pair_t *dst = (pixel_pair_t *)sprite->buffer;
+    uint32_t n = (uint32_t)dl->width * dl->height;
+
+    for (uint32_t i = 0; i + 1 < n; i += 2) {
+        *dst++ = pal[src[i] & (DISPLAY_LIST_COLORS - 1)] |
+                 ((uint32_t)pal[src[i + 1] & (DISPLAY_LIST_COLORS - 1)] << 16);
+    }
+    if (n & 1) {
+        sprite->buffer[n - 1] = pal[src[n - 1] & (DISPLAY_LIST_COLORS - 1)];
+    }
+}
+
+void display_list_draw(display_list_t *dl, sprite_t *sprite) {
+    if (sprite->width != dl->width || sprite->height != dl->height) return;
+
+    // Already holds this exact scene and palette
+    uint8_t slot = 0;
+    for (uint8_t i = 0; i < DISPLAY_LIST_TARGETS; i++) {
+        if (dl->targets[i].sprite == sprite) {
+            if (dl->targets[i].stamp == dl->stamp) return;
+            slot = i;
+            break;
+        }
+        // Otherwise reuse the stalest slot
+        if (dl->targets[i].stamp < dl->targets[slot].stamp) slot = i;
+    }
+
+    if (!display_list_reserve(dl)) return;
+    if (!dl->cache_valid) {
+        rasterize(dl, sprite);
+    }
+    expand(dl, sprite);
+
+    dl->targets[slot].sprite = sprite;
+    dl->targets[slot].stamp = dl->stamp;
+}
+
+bool display_list_reserve(display_list_t *dl) {
+    if (!dl->cache) {
+        dl->cache = arena_alloc(dl->arena, (uint32_t)dl->width * dl->height, ARENA_ALIGN);
+    }
+    return dl->cache != NULL;
+}
+
+bool display_list_prepare(display_list_t *dl, sprite_t *scratch) {
+    if (scratch->width != dl->width || scratch->height != dl->height) return false;
+    if (!display_list_reserve(dl)) return false;
+
+    if (!dl->cache_valid) {
+        rasterize(dl, scratch);
+        display_list_forget(dl, scratch);
+    }
+    return true;
+}
+
+void display_list_forget(display_list_t *dl, const sprite_t *sprite) {
+    for (uint8_t i = 0; i < DISPLAY_LIST_TARGETS; i++) {
+        if (dl->targets[i].sprite == sprite) {
+            dl->targets[i].sprite = NULL;
+            dl->targets[i].stamp = 0;
+        }
+    }
+}
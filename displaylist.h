@@ -0,0 +1,106 @@
+#ifndef DISPLAYLIST_H
+#define DISPLAYLIST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "display.h"
+
+// Palette entries available to a display list
+#define DISPLAY_LIST_COLORS  16
+
+// Sprites whose contents the list remembers; two covers a double buffer
+#define DISPLAY_LIST_TARGETS 2
+
+typedef enum {
+    DL_FILL,
+    DL_RECT,
+    DL_ROUND_RECT,
+    DL_CIRCLE,
+    DL_TRIANGLE,
+    DL_LINE
+} display_list_op_t;
+
+// One recorded primitive; colors are palette indices
+typedef struct {
+    uint8_t op;               // display_list_op_t
+    uint8_t color;
+    int16_t args[6];
+} display_list_cmd_t;
+
+// Retained-mode scene: primitives are recorded once and rasterized into
+// a cached index buffer, which is only expanded through the palette when
+// drawn. Changing a palette entry re-expands without re-rasterizing, and
+// drawing an unchanged scene into a sprite that already holds it is free.
+// Position is not part of the scene; the compositor places the sprite.
+typedef struct {
+    display_list_cmd_t *cmds;
+    uint16_t count;
+    uint16_t capacity;
+
+    uint16_t width;
+    uint16_t height;
+    uint16_t palette[DISPLAY_LIST_COLORS];
+
+    uint8_t *cache;           // Rasterized palette indices, width * height,
+                              // allocated by the first display_list_draw
+    bool cache_valid;
+    arena_t *arena;           // Holds cmds and cache
+
+    // Bumped on any change; a target holding the current stamp is up to date
+    uint32_t stamp;
+    struct {
+        const sprite_t *sprite;
+        uint32_t stamp;
+    } targets[DISPLAY_LIST_TARGETS];
+} display_list_t;
+
+// Storage comes from arena_static; freeing gives it back only if nothing
+// was allocated there since (see sprite_free)
+bool display_list_init(display_list_t *dl, uint16_t width, uint16_t height, uint16_t capacity);
+void display_list_free(display_list_t *dl);
+
+// Start recording a new scene (drops the cached raster)
+void display_list_clear(display_list_t *dl);
+
+// Recording; each returns false if the list is full
+bool display_list_fill(display_list_t *dl, uint8_t color);
+bool display_list_rect(display_list_t *dl, int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color);
+bool display_list_round_rect(display_list_t *dl, int16_t x, int16_t y, int16_t w, int16_t h,
+                             int16_t r, uint8_t color);
+bool display_list_circle(display_list_t *dl, int16_t x, int16_t y, int16_t r, uint8_t color);
+bool display_list_triangle(display_list_t *dl, int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                           int16_t x2, int16_t y2, uint8_t color);
+bool display_list_line(display_list_t *dl, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t color);
+
+// Dots of radius dot_r along an arc, angles in whole degrees (clockwise
+// from +x since y points down). Positions come from fixed.h trig at
+// record time, so the scene itself holds only circles.
+bool display_list_arc_dots(display_list_t *dl, int16_t cx, int16_t cy, int16_t radius,
+                           int16_t start_deg, int16_t end_deg, int16_t step_deg,
+                           int16_t dot_r, uint8_t color);
+
+void display_list_set_color(display_list_t *dl, uint8_t index, uint16_t color);
+
+// Bring the sprite up to date with the scene. The sprite must match the
+// list's dimensions. Does nothing if the index cache cannot be allocated.
+void display_list_draw(display_list_t *dl, sprite_t *sprite);
+
+// Allocate the index cache now rather than on the first draw; false if
+// the arena has no room
+bool display_list_reserve(display_list_t *dl);
+
+// Reserve the cache and rasterize the scene into it, so later draws only
+// expand the palette and allocate nothing. scratch must match the list's
+// dimensions and is left holding indices, not a drawable image.
+bool display_list_prepare(display_list_t *dl, sprite_t *scratch);
+
+// The sprite was drawn over by something else; the next draw into it
+// expands the scene again instead of assuming it is still there
+void display_list_forget(display_list_t *dl, const sprite_t *sprite);
+
+// Rasterize the part of the scene whose top-left corner is (x, y) straight
+// into the sprite in RGB565, bypassing the cache. The sprite may be any
+// size; this is how a scene larger than RAM allows is drawn in tiles.
+void display_list_render(const display_list_t *dl, sprite_t *sprite, int16_t x, int16_t y);
+
+#endif // DISPLAYLIST_H
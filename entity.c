@@ -0,0 +1,282 @@
+#include "entity.h"
+#include <string.h>
+
+// ===== WORLD =====
+
+bool entity_world_init(entity_world_t *world, arena_t *arena, uint16_t capacity,
+                       int16_t width, int16_t height) {
+    memset(world, 0, sizeof(*world));
+    if (capacity == 0 || capacity >= ENTITY_NONE || width <= 0 || height <= 0) return false;
+
+    uint16_t cell = 1 << ENTITY_CELL_SHIFT;
+    uint16_t cols = (width + cell - 1) >> ENTITY_CELL_SHIFT;
+    uint16_t rows = (height + cell - 1) >> ENTITY_CELL_SHIFT;
+
+    arena_mark_t mark = arena_mark(arena);
+    world->x = arena_alloc(arena, capacity * sizeof(q16_t), ARENA_ALIGN);
+    world->y = arena_alloc(arena, capacity * sizeof(q16_t), ARENA_ALIGN);
+    world->vx = arena_alloc(arena, capacity * sizeof(q16_t), ARENA_ALIGN);
+    world->vy = arena_alloc(arena, capacity * sizeof(q16_t), ARENA_ALIGN);
+    world->w = arena_alloc(arena, capacity * sizeof(int16_t), ARENA_ALIGN);
+    world->h = arena_alloc(arena, capacity * sizeof(int16_t), ARENA_ALIGN);
+    world->sprite = arena_alloc(arena, capacity * sizeof(sprite_t *), ARENA_ALIGN);
+    world->flags = arena_alloc(arena, capacity, ARENA_ALIGN);
+    world->slot_id = arena_alloc(arena, capacity * sizeof(entity_id_t), ARENA_ALIGN);
+    world->id_slot = arena_alloc(arena, capacity * sizeof(uint16_t), ARENA_ALIGN);
+    world->free_ids = arena_alloc(arena, capacity * sizeof(entity_id_t), ARENA_ALIGN);
+    world->cell_start = arena_alloc(arena, (cols * rows + 1) * sizeof(uint16_t), ARENA_ALIGN);
+    world->cell_items = arena_alloc(arena, capacity * sizeof(uint16_t), ARENA_ALIGN);
+    world->slot_cell = arena_alloc(arena, capacity * sizeof(uint16_t), ARENA_ALIGN);
+
+    if (!world->x || !world->y || !world->vx || !world->vy || !world->w || !world->h ||
+        !world->sprite || !world->flags || !world->slot_id || !world->id_slot ||
+        !world->free_ids || !world->cell_start || !world->cell_items || !world->slot_cell) {
+        arena_release(arena, mark);
+        memset(world, 0, sizeof(*world));
+        return false;
+    }
+
+    world->capacity = capacity;
+    world->width = width;
+    world->height = height;
+    world->cols = cols;
+    world->rows = rows;
+    entity_world_clear(world);
+    return true;
+}
+
+void entity_world_clear(entity_world_t *world) {
+    world->count = 0;
+
+    // Hand out low ids first
+    for (uint16_t i = 0; i < world->capacity; i++) {
+        world->id_slot[i] = ENTITY_NONE;
+        world->free_ids[i] = world->capacity - 1 - i;
+    }
+    world->free_count = world->capacity;
+
+    world->hashed = 0;
+    memset(world->cell_start, 0, (world->cols * world->rows + 1) * sizeof(uint16_t));
+}
+
+entity_id_t entity_spawn(entity_world_t *world, int16_t x, int16_t y, int16_t w, int16_t h) {
+    if (world->free_count == 0) return ENTITY_NONE;
+
+    entity_id_t id = world->free_ids[--world->free_count];
+    uint16_t s = world->count++;
+
+    world->x[s] = q16_from_int(x);
+    world->y[s] = q16_from_int(y);
+    world->vx[s] = 0;
+    world->vy[s] = 0;
+    world->w[s] = w;
+    world->h[s] = h;
+    world->sprite[s] = NULL;
+    world->flags[s] = 0;
+    world->slot_id[s] = id;
+    world->id_slot[id] = s;
+    return id;
+}
+
+void entity_despawn(entity_world_t *world, entity_id_t id) {
+    if (!entity_alive(world, id)) return;
+
+    // Move the last entity into the hole to keep slots dense
+    uint16_t s = world->id_slot[id];
+    uint16_t last = --world->count;
+    if (s != last) {
+        world->x[s] = world->x[last];
+        world->y[s] = world->y[last];
+        world->vx[s] = world->vx[last];
+        world->vy[s] = world->vy[last];
+        world->w[s] = world->w[last];
+        world->h[s] = world->h[last];
+        world->sprite[s] = world->sprite[last];
+        world->flags[s] = world->flags[last];
+        world->slot_id[s] = world->slot_id[last];
+        world->id_slot[world->slot_id[s]] = s;
+    }
+
+    world->id_slot[id] = ENTITY_NONE;
+    world->free_ids[world->free_count++] = id;
+}
+
+// ===== BATCHED PASSES =====
+
+void entity_integrate(entity_world_t *world, uint32_t step_us) {
+    // Step length in seconds as a 0.32 fraction, so each axis is one
+    // multiply and shift (steps must be under a second)
+    uint32_t k = (uint32_t)(((uint64_t)step_us << 32) / 1000000);
+
+    q16_t *x = world->x;
+    const q16_t *vx = world->vx;
+    for (uint16_t i = 0; i < world->count; i++) {
+        x[i] += (q16_t)(((int64_t)vx[i] * k) >> 32);
+    }
+
+    q16_t *y = world->y;
+    const q16_t *vy = world->vy;
+    for (uint16_t i = 0; i < world->count; i++) {
+        y[i] += (q16_t)(((int64_t)vy[i] * k) >> 32);
+    }
+}
+
+// One axis of entity_confine
+static void confine_axis(q16_t *pos, q16_t *vel, int16_t size, int16_t limit, bool bounce) {
+    q16_t hi = q16_from_int(limit - size);
+
+    if (*pos < 0) {
+        *pos = 0;
+        if (!bounce) *vel = 0;
+        else if (*vel < 0) *vel = -*vel;
+    } else if (*pos > hi) {
+        *pos = hi > 0 ? hi : 0;
+        if (!bounce) *vel = 0;
+        else if (*vel > 0) *vel = -*vel;
+    }
+}
+
+void entity_confine(entity_world_t *world) {
+    for (uint16_t i = 0; i < world->count; i++) {
+        bool bounce = world->flags[i] & ENTITY_BOUNCE;
+        confine_axis(&world->x[i], &world->vx[i], world->w[i], world->width, bounce);
+        confine_axis(&world->y[i], &world->vy[i], world->h[i], world->height, bounce);
+    }
+}
+
+// Grid coordinate of a pixel position, with anything off the world
+// filed under the edge cells
+static inline uint16_t cell_coord(int32_t v, uint16_t cells) {
+    int32_t c = v >> ENTITY_CELL_SHIFT;
+    return c < 0 ? 0 : c >= cells ? cells - 1 : c;
+}
+
+void entity_hash_build(entity_world_t *world) {
+    uint16_t cells = world->cols * world->rows;
+    uint16_t *start = world->cell_start;
+    int16_t max_w = 0;
+    int16_t max_h = 0;
+
+    // Counting sort by cell: count, prefix sum, then place
+    memset(start, 0, (cells + 1) * sizeof(uint16_t));
+    for (uint16_t i = 0; i < world->count; i++) {
+        uint16_t cx = cell_coord(q16_floor(world->x[i]), world->cols);
+        uint16_t cy = cell_coord(q16_floor(world->y[i]), world->rows);
+        uint16_t c = cy * world->cols + cx;
+        world->slot_cell[i] = c;
+        start[c + 1]++;
+
+        if (world->w[i] > max_w) max_w = world->w[i];
+        if (world->h[i] > max_h) max_h = world->h[i];
+    }
+    for (uint16_t c = 0; c < cells; c++) {
+        start[c + 1] += start[c];
+    }
+
+    // Fill each cell from its end, so slots come out ascending within
+    // it; afterwards start[c + 1] holds where cell c begins
+    for (uint16_t i = world->count; i > 0; i--) {
+        uint16_t c = world->slot_cell[i - 1];
+        world->cell_items[--start[c + 1]] = i - 1;
+    }
+    for (uint16_t c = 0; c < cells; c++) {
+        start[c] = start[c + 1];
+    }
+    start[cells] = world->count;
+
+    world->hashed = world->count;
+    world->max_w = max_w;
+    world->max_h = max_h;
+}
+
+// ===== QUERIES =====
+
+// Cells that can hold the top-left corner of an entity overlapping the
+// rectangle x0,y0 to x1,y1 (exclusive)
+typedef struct {
+    uint16_t cx0, cx1;
+    uint16_t cy0, cy1;
+} cell_range_t;
+
+static cell_range_t query_cells(const entity_world_t *world, int32_t x0, int32_t y0,
+                                int32_t x1, int32_t y1) {
+    return (cell_range_t){
+        cell_coord(x0 - world->max_w + 1, world->cols),
+        cell_coord(x1 - 1, world->cols),
+        cell_coord(y0 - world->max_h + 1, world->rows),
+        cell_coord(y1 - 1, world->rows),
+    };
+}
+
+static inline bool slot_overlaps(const entity_world_t *world, uint16_t s,
+                                 int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
+    int32_t ex = q16_floor(world->x[s]);
+    int32_t ey = q16_floor(world->y[s]);
+    return ex < x1 && ex + world->w[s] > x0 && ey < y1 && ey + world->h[s] > y0;
+}
+
+uint16_t entity_query(const entity_world_t *world, int16_t x, int16_t y, int16_t w, int16_t h,
+                      entity_id_t *out, uint16_t max) {
+    uint16_t n = 0;
+    if (world->hashed == 0 || w <= 0 || h <= 0) return 0;
+
+    int32_t x1 = x + w;
+    int32_t y1 = y + h;
+    cell_range_t r = query_cells(world, x, y, x1, y1);
+    for (uint16_t cy = r.cy0; cy <= r.cy1; cy++) {
+        // A row's cells are contiguous in cell_items
+        const uint16_t *row = &world->cell_start[cy * world->cols];
+        for (uint16_t e = row[r.cx0]; e < row[r.cx1 + 1]; e++) {
+            uint16_t s = world->cell_items[e];
+            if (s >= world->count || !slot_overlaps(world, s, x, y, x1, y1)) continue;
+            if (n == max) return n;
+            out[n++] = world->slot_id[s];
+        }
+    }
+    return n;
+}
+
+entity_id_t entity_hit_test(const entity_world_t *world, int16_t x, int16_t y) {
+    entity_id_t hit = ENTITY_NONE;
+    if (world->hashed == 0) return hit;
+
+    cell_range_t r = query_cells(world, x, y, x + 1, y + 1);
+    for (uint16_t cy = r.cy0; cy <= r.cy1; cy++) {
+        const uint16_t *row = &world->cell_start[cy * world->cols];
+        for (uint16_t e = row[r.cx0]; e < row[r.cx1 + 1]; e++) {
+            uint16_t s = world->cell_items[e];
+            if (s >= world->count || (world->flags[s] & ENTITY_HIDDEN)) continue;
+            if (!slot_overlaps(world, s, x, y, x + 1, y + 1)) continue;
+            entity_id_t id = world->slot_id[s];
+            if (hit == ENTITY_NONE || id > hit) hit = id;
+        }
+    }
+    return hit;
+}
+
+uint32_t entity_collide(entity_world_t *world, entity_pair_fn fn, void *ctx) {
+    uint32_t pairs = 0;
+    if (world->hashed == 0) return 0;
+
+    for (uint16_t a = 0; a < world->count; a++) {
+        if (!(world->flags[a] & ENTITY_SOLID)) continue;
+
+        int32_t x0 = q16_floor(world->x[a]);
+        int32_t y0 = q16_floor(world->y[a]);
+        int32_t x1 = x0 + world->w[a];
+        int32_t y1 = y0 + world->h[a];
+        cell_range_t r = query_cells(world, x0, y0, x1, y1);
+        for (uint16_t cy = r.cy0; cy <= r.cy1; cy++) {
+            const uint16_t *row = &world->cell_start[cy * world->cols];
+            for (uint16_t e = row[r.cx0]; e < row[r.cx1 + 1]; e++) {
+                // Each pair is found from both ends; report it from the lower slot
+                uint16_t b = world->cell_items[e];
+                if (b <= a || b >= world->count || !(world->flags[b] & ENTITY_SOLID)) continue;
+                if (!slot_overlaps(world, b, x0, y0, x1, y1)) continue;
+                pairs++;
+                if (fn) fn(world, world->slot_id[a], world->slot_id[b], ctx);
+            }
+        }
+    }
+    return pairs;
+}
@@ -0,0 +1,121 @@
+#ifndef ENTITY_H
+#define ENTITY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "display.h"
+#include "arena.h"
+#include "fixed.h"
+
+// Entity store for game objects. Components live in parallel arrays
+// indexed by a dense slot, so each update pass walks only the fields it
+// needs, front to back, over live entities only. Despawning moves the
+// last entity into the hole; ids stay valid across that through a
+// separate id -> slot table.
+//
+// A uniform grid (the spatial hash) is rebuilt once per update by
+// entity_hash_build and answers rectangle, point and pair queries
+// without touching far-away entities.
+
+typedef uint16_t entity_id_t;
+
+#define ENTITY_NONE         0xFFFF
+
+// Grid cells are 1 << ENTITY_CELL_SHIFT pixels square. Entities are
+// filed under the cell of their top-left corner; about their own size
+// works best.
+#ifndef ENTITY_CELL_SHIFT
+#define ENTITY_CELL_SHIFT   5
+#endif
+
+// Entity flags
+#define ENTITY_SOLID        0x01    // Takes part in entity_collide
+#define ENTITY_BOUNCE       0x02    // entity_confine reflects its velocity
+#define ENTITY_HIDDEN       0x04    // Ignored by hit tests
+
+typedef struct {
+    uint16_t count;           // Live entities, in slots 0..count-1
+    uint16_t capacity;
+    int16_t width;            // World bounds, 0,0 to width,height
+    int16_t height;
+
+    // Components, indexed by slot
+    q16_t *x;                 // Top-left corner, pixels
+    q16_t *y;
+    q16_t *vx;                // Pixels per second
+    q16_t *vy;
+    int16_t *w;               // Bounds
+    int16_t *h;
+    const sprite_t **sprite;
+    uint8_t *flags;
+
+    // Id bookkeeping
+    entity_id_t *slot_id;     // Slot -> id
+    uint16_t *id_slot;        // Id -> slot, or ENTITY_NONE if free
+    entity_id_t *free_ids;
+    uint16_t free_count;
+
+    // Spatial hash: entries of cell c are cell_items[cell_start[c]] up to
+    // cell_items[cell_start[c + 1]]
+    uint16_t cols;
+    uint16_t rows;
+    uint16_t *cell_start;
+    uint16_t *cell_items;     // Slots
+    uint16_t *slot_cell;
+    uint16_t hashed;          // Slots filed by the last build
+    int16_t max_w;            // Largest bounds when the hash was built
+    int16_t max_h;
+} entity_world_t;
+
+// Called for each overlapping pair of solid entities
+typedef void (*entity_pair_fn)(entity_world_t *world, entity_id_t a, entity_id_t b, void *ctx);
+
+// Carve storage for capacity entities from arena (all or nothing)
+bool entity_world_init(entity_world_t *world, arena_t *arena, uint16_t capacity,
+                       int16_t width, int16_t height);
+
+// Remove every entity
+void entity_world_clear(entity_world_t *world);
+
+// New entity at x,y with a w x h box. ENTITY_NONE if the world is full.
+entity_id_t entity_spawn(entity_world_t *world, int16_t x, int16_t y, int16_t w, int16_t h);
+void entity_despawn(entity_world_t *world, entity_id_t id);
+
+static inline bool entity_alive(const entity_world_t *world, entity_id_t id) {
+    return id < world->capacity && world->id_slot[id] != ENTITY_NONE;
+}
+
+// Slot of a live entity, for direct component access
+static inline uint16_t entity_slot(const entity_world_t *world, entity_id_t id) {
+    return world->id_slot[id];
+}
+
+// ===== BATCHED PASSES =====
+
+// Move every entity by its velocity over step_us
+void entity_integrate(entity_world_t *world, uint32_t step_us);
+
+// Keep every entity inside the world; bouncing ones reverse direction
+// at the edges, others stop there
+void entity_confine(entity_world_t *world);
+
+// Refile every entity in the grid. Call after moving, spawning or
+// despawning and before querying: until then queries can miss entities.
+void entity_hash_build(entity_world_t *world);
+
+// ===== QUERIES =====
+
+// Ids of entities whose bounds overlap the rectangle, up to max.
+// Returns how many were written.
+uint16_t entity_query(const entity_world_t *world, int16_t x, int16_t y, int16_t w, int16_t h,
+                      entity_id_t *out, uint16_t max);
+
+// Visible entity under the point, the highest id if several overlap;
+// ENTITY_NONE if there is none
+entity_id_t entity_hit_test(const entity_world_t *world, int16_t x, int16_t y);
+
+// Report each overlapping pair of solid entities once. fn must not spawn
+// or despawn. Returns the number of pairs.
+uint32_t entity_collide(entity_world_t *world, entity_pair_fn fn, void *ctx);
+
+#endif // ENTITY_H
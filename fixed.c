@@ -0,0 +1,140 @@
+#include "fixed.h"
+
+// sin() in Q15 over a quarter turn, 256 steps plus the end point
+static const q15_t sin_table[257] = {
+    0, 201, 402, 603, 804, 1005, 1206, 1407, 1608, 1809, 2009, 2210,
+    2410, 2611, 2811, 3012, 3212, 3412, 3612, 3811, 4011, 4210, 4410, 4609,
+    4808, 5007, 5205, 5404, 5602, 5800, 5998, 6195, 6393, 6590, 6786, 6983,
+    7179, 7375, 7571, 7767, 7962, 8157, 8351, 8545, 8739, 8933, 9126, 9319,
+    9512, 9704, 9896, 10087, 10278, 10469, 10659, 10849, 11039, 11228, 11417, 11605,
+    11793, 11980, 12167, 12353, 12539, 12725, 12910, 13094, 13279, 13462, 13645, 13828,
+    14010, 14191, 14372, 14553, 14732, 14912, 15090, 15269, 15446, 15623, 15800, 15976,
+    16151, 16325, 16499, 16673, 16846, 17018, 17189, 17360, 17530, 17700, 17869, 18037,
+    18204, 18371, 18537, 18703, 18868, 19032, 19195, 19357, 19519, 19680, 19841, 20000,
+    20159, 20317, 20475, 20631, 20787, 20942, 21096, 21250, 21403, 21554, 21705, 21856,
+    22005, 22154, 22301, 22448, 22594, 22739, 22884, 23027, 23170, 23311, 23452, 23592,
+    23731, 23870, 24007, 24143, 24279, 24413, 24547, 24680, 24811, 24942, 25072, 25201,
+    25329, 25456, 25582, 25708, 25832, 25955, 26077, 26198, 26319, 26438, 26556, 26674,
+    26790, 26905, 27019, 27133, 27245, 27356, 27466, 27575, 27683, 27790, 27896, 28001,
+    28105, 28208, 28310, 28411, 28510, 28609, 28706, 28803, 28898, 28992, 29085, 29177,
+    29268, 29358, 29447, 29534, 29621, 29706, 29791, 29874, 29956, 30037, 30117, 30195,
+    30273, 30349, 30424, 30498, 30571, 30643, 30714, 30783, 30852, 30919, 30985, 31050,
+    31113, 31176, 31237, 31297, 31356, 31414, 31470, 31526, 31580, 31633, 31685, 31736,
+    31785, 31833, 31880, 31926, 31971, 32014, 32057, 32098, 32137, 32176, 32213, 32250,
+    32285, 32318, 32351, 32382, 32412, 32441, 32469, 32495, 32521, 32545, 32567, 32589,
+    32609, 32628, 32646, 32663, 32678, 32692, 32705, 32717, 32728, 32737, 32745, 32752,
+    32757, 32761, 32765, 32766, 32767,
+};
+
+// atan(i / 64) for i = 0..64, in angle units (1/8 turn at the end)
+static const uint16_t atan_table[65] = {
+    0, 163, 326, 489, 651, 813, 975, 1136, 1297, 1457, 1617, 1775,
+    1933, 2090, 2246, 2401, 2555, 2708, 2860, 3010, 3159, 3307, 3453, 3599,
+    3742, 3884, 4025, 4164, 4302, 4438, 4572, 4705, 4836, 4966, 5094, 5220,
+    5344, 5467, 5589, 5708, 5826, 5943, 6058, 6171, 6282, 6392, 6500, 6607,
+    6712, 6815, 6917, 7018, 7117, 7214, 7310, 7405, 7498, 7589, 7679, 7768,
+    7856, 7942, 8026, 8110, 8192,
+};
+
+// ===== TRIG =====
+
+// a is a fraction of a turn in 24 bits, so degrees need not be rounded
+// to whole angle units first
+static q15_t sin_turn24(uint32_t a) {
+    // Fold onto the first quadrant; the second and fourth run backwards
+    uint32_t q = a & 0x3FFFFF;
+    if (a & 0x400000) q = 0x400000 - q;
+
+    // 8 bits of table index and 14 of interpolation
+    uint32_t i = q >> 14;
+    int32_t frac = q & 0x3FFF;
+    int32_t s = sin_table[i];
+    if (frac) s += ((sin_table[i + 1] - s) * frac + 0x2000) >> 14;
+
+    return (q15_t)(a & 0x800000 ? -s : s);
+}
+
+q15_t fx_sin(angle_t a) {
+    return sin_turn24((uint32_t)a << 8);
+}
+
+q15_t fx_cos(angle_t a) {
+    return sin_turn24((uint32_t)(angle_t)(a + 0x4000) << 8);
+}
+
+static uint32_t deg_to_turn24(int32_t deg) {
+    deg %= 360;
+    if (deg < 0) deg += 360;
+    return (uint32_t)(((uint64_t)deg << 24) / 360);
+}
+
+q15_t fx_sin_deg(int32_t deg) {
+    return sin_turn24(deg_to_turn24(deg));
+}
+
+q15_t fx_cos_deg(int32_t deg) {
+    return sin_turn24(deg_to_turn24(deg + 90));
+}
+
+angle_t fx_atan2(int32_t y, int32_t x) {
+    if (x == 0 && y == 0) return 0;
+
+    uint32_t ax = x < 0 ? -(uint32_t)x : (uint32_t)x;
+    uint32_t ay = y < 0 ? -(uint32_t)y : (uint32_t)y;
+
+    // atan of the smaller over the larger, from the table in 6.10 steps
+    uint32_t lo = ax < ay ? ax : ay;
+    uint32_t hi = ax < ay ? ay : ax;
+    uint32_t r = (uint32_t)(((uint64_t)lo << 16) / hi);
+    uint32_t i = r >> 10;
+    int32_t frac = r & 0x3FF;
+    int32_t t = atan_table[i];
+    if (frac) t += ((atan_table[i + 1] - t) * frac + 512) >> 10;
+
+    // Unfold the octant
+    uint16_t a = ay > ax ? 0x4000 - t : t;
+    if (x < 0) a = 0x8000 - a;
+    if (y < 0) a = -a;
+    return a;
+}
+
+// ===== ROOTS =====
+
+uint32_t isqrt32(uint32_t v) {
+    uint32_t r = 0;
+    uint32_t bit = 1u << 30;
+    while (bit > v) bit >>= 2;
+    while (bit) {
+        if (v >= r + bit) {
+            v -= r + bit;
+            r = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+    return r;
+}
+
+uint32_t isqrt64(uint64_t v) {
+    if (v <= UINT32_MAX) return isqrt32((uint32_t)v);
+
+    uint64_t r = 0;
+    uint64_t bit = 1ull << 62;
+    while (bit > v) bit >>= 2;
+    while (bit) {
+        if (v >= r + bit) {
+            v -= r + bit;
+            r = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)r;
+}
+
+q16_t q16_sqrt(q16_t v) {
+    if (v <= 0) return 0;
+    return (q16_t)isqrt64((uint64_t)v << 16);
+}
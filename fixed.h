@@ -0,0 +1,72 @@
+#ifndef FIXED_H
+#define FIXED_H
+
+#include <stdint.h>
+
+// Fixed-point math for render and motion code, so nothing in the frame
+// path goes through soft-float libm. Two formats:
+//   q16_t  Q16.16, for positions, velocities and general arithmetic
+//   q15_t  Q1.15, for unit values such as sin/cos (1.0 is 32767)
+// Angles are binary: a full turn is 65536, so they wrap for free.
+
+typedef int32_t q16_t;
+typedef int16_t q15_t;
+typedef uint16_t angle_t;
+
+#define Q16_ONE         65536
+#define Q15_ONE         32767
+
+#define Q16(x)          ((q16_t)((x) * 65536.0))      // Constants only
+#define ANGLE_DEG(d)    ((angle_t)((int32_t)(d) * 65536 / 360))
+
+static inline q16_t q16_from_int(int32_t v) {
+    return (q16_t)((uint32_t)v << 16);
+}
+
+// Round to nearest, halves up
+static inline int32_t q16_round(q16_t v) {
+    return (v + 0x8000) >> 16;
+}
+
+static inline int32_t q16_floor(q16_t v) {
+    return v >> 16;
+}
+
+static inline q16_t q16_mul(q16_t a, q16_t b) {
+    return (q16_t)(((int64_t)a * b) >> 16);
+}
+
+static inline q16_t q16_div(q16_t a, q16_t b) {
+    return (q16_t)(((int64_t)a << 16) / b);
+}
+
+// Q15 * Q15 -> Q15
+static inline q15_t q15_mul(q15_t a, q15_t b) {
+    return (q15_t)(((int32_t)a * b + 0x4000) >> 15);
+}
+
+// Scale an integer by a Q15 value, rounding to nearest
+static inline int32_t q15_scale(q15_t q, int32_t v) {
+    int32_t p = q * v;
+    return (p + (p >= 0 ? 0x4000 : -0x4000)) / 0x8000;
+}
+
+// Table-driven, linearly interpolated; within 1 LSB of libm
+q15_t fx_sin(angle_t a);
+q15_t fx_cos(angle_t a);
+
+// Degrees, any sign or size
+q15_t fx_sin_deg(int32_t deg);
+q15_t fx_cos_deg(int32_t deg);
+
+// Angle of (x, y) from the +x axis, within about 0.01 degrees; 0 for (0, 0)
+angle_t fx_atan2(int32_t y, int32_t x);
+
+// Integer square roots, rounded down
+uint32_t isqrt32(uint32_t v);
+uint32_t isqrt64(uint64_t v);
+
+// Square root of a non-negative Q16.16 value
+q16_t q16_sqrt(q16_t v);
+
+#endif // FIXED_H
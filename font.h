@@ -0,0 +1,34 @@
+#ifndef FONT_H
+#define FONT_H
+
+#include <stdint.h>
+
+// Antialiased bitmap font, generated from TrueType by tools/assetc.py.
+// Glyph bitmaps are 4-bit coverage (15 = solid) with rows padded to a
+// whole byte and the leftmost pixel in the high nibble.
+typedef struct {
+    uint32_t offset;          // Into font_t.bitmap
+    uint8_t width;
+    uint8_t height;
+    int8_t x_offset;          // Pen position to the bitmap's left edge
+    int8_t y_offset;          // Baseline to the bitmap's top row (negative is above)
+    uint8_t advance;          // Pen movement after the glyph
+} font_glyph_t;
+
+// A run of consecutive code points and where its glyphs start
+typedef struct {
+    uint16_t first;
+    uint16_t count;
+    uint16_t glyph;           // Index into font_t.glyphs
+} font_range_t;
+
+typedef struct {
+    const uint8_t *bitmap;
+    const font_glyph_t *glyphs;
+    const font_range_t *ranges;
+    uint8_t range_count;
+    uint8_t ascent;           // Top of a line to the baseline
+    uint8_t line_height;
+} font_t;
+
+#endif // FONT_H
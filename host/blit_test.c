@@ -0,0 +1,213 @@
+/**
+ * Lil Guy - Layer Blit Test
+ * Composites random stacks of layers in all four blit modes with
+ * blit_region() and blit_move() onto the emulated panel, and checks every
+ * panel pixel against a naive per-pixel composite of the same layers.
+ * Masks are built from runs of fully clear and fully set bytes mixed
+ * with random ones, so the whole-byte alpha1 and opaque-run alpha4 fast
+ * paths are taken as well as the per-pixel ones, and full-width opaque
+ * layers exercise the skip of everything they cover.
+ *
+ * Usage: lil_guy_blit_test [rounds]
+ * Exits non-zero if any pixel differs.
+ */
+
+#include "blit.h"
+#include "st7796.h"
+#include "tft_bus.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+_Static_assert(TFT_ROTATION == TFT_ROTATE_0, "blit_test expects the portrait build");
+
+#define LAYERS          6
+#define MAX_SIZE        120
+#define BACKGROUND      COLOR_WHITE
+
+static uint16_t pixels[LAYERS][MAX_SIZE * MAX_SIZE];
+static uint8_t masks[LAYERS][MAX_SIZE * MAX_SIZE];
+static sprite_t sprites[LAYERS];
+static blit_layer_t layers[LAYERS];
+
+static uint16_t expected[TFT_WIDTH * TFT_HEIGHT];
+
+static const char *mode_names[] = {"opaque", "colorkey", "alpha1", "alpha4"};
+
+// ===== REFERENCE =====
+
+static uint8_t mask_alpha(const blit_layer_t *l, int16_t sx, int16_t sy) {
+    uint16_t w = l->sprite->width;
+    if (l->mode == BLIT_ALPHA1) {
+        uint8_t byte = l->mask[sy * ((w + 7) / 8) + sx / 8];
+        return byte & (0x80 >> (sx & 7)) ? 15 : 0;
+    }
+    uint8_t byte = l->mask[sy * ((w + 1) / 2) + sx / 2];
+    return sx & 1 ? byte & 0x0F : byte >> 4;
+}
+
+static uint16_t composite(int16_t px, int16_t py) {
+    uint16_t c = BACKGROUND;
+    for (uint8_t i = 0; i < LAYERS; i++) {
+        const blit_layer_t *l = &layers[i];
+        int16_t sx = px - l->x;
+        int16_t sy = py - l->y;
+        if (l->hidden || sx < 0 || sy < 0 || sx >= l->sprite->width || sy >= l->sprite->height) continue;
+
+        uint16_t src = l->sprite->buffer[sy * l->sprite->width + sx];
+        switch (l->mode) {
+            case BLIT_OPAQUE:
+                c = src;
+                break;
+            case BLIT_COLORKEY:
+                if (src != l->key) c = src;
+                break;
+            default: {
+                uint8_t level = mask_alpha(l, sx, sy);
+                if (level == 15) c = src;
+                else if (level) c = blend565(src, c, level * 17);
+                break;
+            }
+        }
+    }
+    return c;
+}
+
+// Expected panel contents after compositing this rectangle
+static void reference_region(int16_t x, int16_t y, int16_t w, int16_t h) {
+    for (int16_t py = y; py < y + h; py++) {
+        for (int16_t px = x; px < x + w; px++) {
+            if (px >= 0 && py >= 0 && px < TFT_WIDTH && py < TFT_HEIGHT) {
+                expected[py * TFT_WIDTH + px] = composite(px, py);
+            }
+        }
+    }
+}
+
+// ===== RANDOM LAYERS =====
+
+static uint8_t mask_byte(void) {
+    switch (rand() % 4) {
+        case 0:  return 0x00;
+        case 1:  return 0xFF;
+        default: return rand();
+    }
+}
+
+static void make_layer(uint8_t i) {
+    sprite_t *s = &sprites[i];
+    s->buffer = pixels[i];
+    s->width = rand() % MAX_SIZE + 1;
+    s->height = rand() % MAX_SIZE + 1;
+
+    blit_layer_t *l = &layers[i];
+    l->sprite = s;
+    l->mask = masks[i];
+    l->mode = rand() % 4;
+    l->x = rand() % (TFT_WIDTH + 60) - 30;
+    l->y = rand() % (TFT_HEIGHT + 60) - 30;
+    l->key = COLOR_MAGENTA;
+    l->hidden = rand() % 8 == 0;
+
+    // Now and then a full-width opaque band that covers what is below it
+    if (l->mode == BLIT_OPAQUE && rand() % 3 == 0) {
+        s->width = MAX_SIZE;
+        l->x = rand() % (TFT_WIDTH - MAX_SIZE);
+    }
+
+    // Key-colored runs so colorkey has gaps to skip
+    for (uint32_t p = 0; p < (uint32_t)s->width * s->height; p++) {
+        s->buffer[p] = rand() % 5 == 0 ? l->key : (uint16_t)rand();
+    }
+
+    // Runs of equal mask bytes, long enough to cover whole 8-pixel groups
+    // and 15-level runs
+    uint32_t bytes = s->height * (l->mode == BLIT_ALPHA1 ? (s->width + 7) / 8 : (s->width + 1) / 2);
+    for (uint32_t b = 0; b < bytes;) {
+        uint8_t v = mask_byte();
+        for (uint32_t run = rand() % 6 + 1; run > 0 && b < bytes; run--) masks[i][b++] = v;
+    }
+}
+
+// ===== CHECKS =====
+
+static uint32_t mismatches(void) {
+    const uint16_t *screen = st7796_screen();
+    uint32_t n = 0;
+    for (uint32_t p = 0; p < TFT_WIDTH * TFT_HEIGHT; p++) {
+        n += screen[p] != expected[p];
+    }
+    return n;
+}
+
+// The whole panel from scratch, so later regions are checked in context
+static void redraw_all(void) {
+    blit_region(layers, LAYERS, BACKGROUND, 0, 0, TFT_WIDTH, TFT_HEIGHT);
+    reference_region(0, 0, TFT_WIDTH, TFT_HEIGHT);
+}
+
+int main(int argc, char **argv) {
+    uint32_t rounds = argc > 1 ? (uint32_t)atoi(argv[1]) : 40;
+    tft_bus_init();
+
+    uint32_t bad = 0;
+    uint32_t mode_counts[4] = {0};
+    for (uint32_t round = 0; round < rounds; round++) {
+        srand(round + 1);
+        for (uint8_t i = 0; i < LAYERS; i++) {
+            make_layer(i);
+            mode_counts[layers[i].mode]++;
+        }
+
+        redraw_all();
+        uint32_t n = mismatches();
+
+        // Random regions, some partly off the panel
+        for (uint8_t k = 0; k < 8 && !n; k++) {
+            int16_t x = rand() % (TFT_WIDTH + 40) - 20;
+            int16_t y = rand() % (TFT_HEIGHT + 40) - 20;
+            int16_t w = rand() % 200 + 1;
+            int16_t h = rand() % 200 + 1;
+            blit_region(layers, LAYERS, BACKGROUND, x, y, w, h);
+            reference_region(x, y, w, h);
+            n = mismatches();
+        }
+
+        // Regions exactly on an opaque layer, and one pixel wider each
+        // side, where the cover skip must and must not apply
+        for (uint8_t i = 0; i < LAYERS && !n; i++) {
+            const blit_layer_t *l = &layers[i];
+            if (l->mode != BLIT_OPAQUE) continue;
+            for (int16_t grow = 0; grow <= 1 && !n; grow++) {
+                int16_t x = l->x - grow;
+                int16_t w = l->sprite->width + 2 * grow;
+                blit_region(layers, LAYERS, BACKGROUND, x, l->y, w, l->sprite->height);
+                reference_region(x, l->y, w, l->sprite->height);
+                n = mismatches();
+            }
+        }
+
+        // Moves, overlapping their old position and not
+        for (uint8_t k = 0; k < 8 && !n; k++) {
+            uint8_t i = rand() % LAYERS;
+            int16_t step = k & 1 ? 8 : 200;
+            int16_t x = layers[i].x + rand() % (2 * step + 1) - step;
+            int16_t y = layers[i].y + rand() % (2 * step + 1) - step;
+            blit_move(layers, LAYERS, BACKGROUND, i, x, y);
+
+            // A moved layer leaves nothing stale anywhere on the panel
+            reference_region(0, 0, TFT_WIDTH, TFT_HEIGHT);
+            n = mismatches();
+        }
+
+        if (n) {
+            printf("round %u: %u pixels differ\n", round, n);
+            bad++;
+        }
+    }
+
+    printf("%u rounds, layers per mode:", rounds);
+    for (uint8_t m = 0; m < 4; m++) printf(" %s %u", mode_names[m], mode_counts[m]);
+    printf("\n%u rounds differ  %s\n", bad, bad ? "FAIL" : "ok");
+    return bad ? 1 : 0;
+}
@@ -0,0 +1,322 @@
+/**
+ * Lil Guy - Display Transfer Benchmark
+ * Frame cost of display.c's DMA transport against the per-pixel
+ * spi_write_blocking() path it replaced, for a full-screen fill and a
+ * 220x220 sprite push. display.c and tft_spi.c run unchanged on stubbed
+ * SPI, GPIO and DMA that advance a virtual clock by a cost model of the
+ * RP2350, so the numbers are estimates of the hardware rather than host
+ * timings: bits take their time on the wire at the SPI baud, and each
+ * SDK call costs the CPU a fixed overhead. A DMA run occupies the bus
+ * but not the CPU, which is what the async push API hands back to the
+ * main loop.
+ *
+ * Usage: lil_guy_display_bench [frames]
+ * Exits non-zero if the two paths send the panel different pixels.
+ */
+
+#include "pico/stdlib.h"
+#include "hardware/gpio.h"
+#include "hardware/spi.h"
+#include "hardware/dma.h"
+#include "display.h"
+#include "tft_bus.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// CPU cost of SDK calls at 150 MHz, beyond any time spent waiting on the
+// bus. Estimates from the SDK sources' instruction counts, not measured.
+#define GPIO_PUT_NS     20      // Call plus one SIO write
+#define SPI_CALL_NS     300     // spi_write_blocking: FIFO loop and RX drain
+#define SPI_FORMAT_NS   100
+#define DMA_START_NS    400     // Channel config and trigger
+
+#define TFT_CMD_RAMWR   0x2C
+#define TFT_CMD_RAMWRC  0x3C
+
+// ===== VIRTUAL HARDWARE =====
+
+struct spi_inst {
+    spi_hw_t hw;
+    uint baud;
+    uint data_bits;
+};
+
+static struct spi_inst spi0_inst = {.data_bits = 8};
+spi_inst_t *const spi0 = &spi0_inst;
+
+static uint64_t now_ns;
+static uint64_t bus_free_ns;    // When the running DMA leaves the wire
+static uint64_t wait_ns;        // CPU time spent waiting for DMA
+
+static uint32_t spi_calls;
+static uint64_t wire_bytes;
+
+// What the panel receives: a hash of the pixel bytes only, since the two
+// paths set windows up with different command framing
+static bool cs_low;
+static bool dc_high;
+static uint8_t last_cmd;
+static uint32_t pixel_hash;
+
+static uint32_t byte_ns(void) {
+    return (uint32_t)(8000000000ull / spi0_inst.baud);
+}
+
+static void wire_send(uint8_t byte) {
+    wire_bytes++;
+    if (!cs_low) return;
+    if (!dc_high) {
+        last_cmd = byte;
+    } else if (last_cmd == TFT_CMD_RAMWR || last_cmd == TFT_CMD_RAMWRC) {
+        pixel_hash = (pixel_hash ^ byte) * 16777619u;
+    }
+}
+
+// The CPU blocks until any DMA still on the wire has finished
+static void wait_bus(void) {
+    if (bus_free_ns > now_ns) {
+        wait_ns += bus_free_ns - now_ns;
+        now_ns = bus_free_ns;
+    }
+}
+
+uint64_t time_us_64(void) {
+    return now_ns / 1000;
+}
+
+void sleep_ms(uint32_t ms) {
+    now_ns += (uint64_t)ms * 1000000;
+}
+
+uint get_core_num(void) {
+    return 0;
+}
+
+void tft_vsync_init(void) {}
+
+void gpio_init(uint gpio) {}
+void gpio_set_dir(uint gpio, bool out) {}
+void gpio_set_function(uint gpio, uint fn) {}
+
+void gpio_put(uint gpio, bool value) {
+    now_ns += GPIO_PUT_NS;
+    if (gpio == TFT_CS) cs_low = !value;
+    if (gpio == TFT_DC) dc_high = value;
+}
+
+uint spi_init(spi_inst_t *spi, uint baudrate) {
+    spi->baud = baudrate;
+    return baudrate;
+}
+
+void spi_set_format(spi_inst_t *spi, uint data_bits, spi_cpol_t cpol, spi_cpha_t cpha, spi_order_t order) {
+    now_ns += SPI_FORMAT_NS;
+    spi->data_bits = data_bits;
+}
+
+int spi_write_blocking(spi_inst_t *spi, const uint8_t *src, size_t len) {
+    wait_bus();
+    for (size_t i = 0; i < len; i++) {
+        wire_send(src[i]);
+    }
+    now_ns += SPI_CALL_NS + (uint64_t)len * byte_ns();
+    spi_calls++;
+    return (int)len;
+}
+
+bool spi_is_busy(const spi_inst_t *spi) {
+    wait_bus();
+    return false;
+}
+
+spi_hw_t *spi_get_hw(spi_inst_t *spi) {
+    return &spi->hw;
+}
+
+uint spi_get_dreq(spi_inst_t *spi, bool is_tx) {
+    return 24;
+}
+
+int dma_claim_unused_channel(bool required) {
+    return 0;
+}
+
+dma_channel_config dma_channel_get_default_config(uint channel) {
+    return (dma_channel_config){.size = DMA_SIZE_32, .read_increment = true, .chain_to = (int)channel};
+}
+
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size) {
+    c->size = size;
+}
+
+void channel_config_set_read_increment(dma_channel_config *c, bool incr) {
+    c->read_increment = incr;
+}
+
+void channel_config_set_write_increment(dma_channel_config *c, bool incr) {}
+void channel_config_set_dreq(dma_channel_config *c, uint dreq) {}
+
+// Only 16-bit runs to the display SPI are needed
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint32_t transfer_count, bool trigger) {
+    wait_bus();
+    now_ns += DMA_START_NS;
+
+    const volatile uint16_t *src = read_addr;
+    for (uint32_t i = 0; i < transfer_count; i++) {
+        uint16_t v = *src;
+        wire_send(v >> 8);
+        wire_send(v & 0xFF);
+        if (config->read_increment) src++;
+    }
+    bus_free_ns = now_ns + (uint64_t)transfer_count * 2 * byte_ns();
+}
+
+bool dma_channel_is_busy(uint channel) {
+    return bus_free_ns > now_ns;
+}
+
+void dma_channel_wait_for_finish_blocking(uint channel) {
+    wait_bus();
+}
+
+// ===== PER-PIXEL PATH =====
+
+// display.c before the DMA transport: every pixel its own blocking call
+
+static void old_write_command(uint8_t cmd) {
+    gpio_put(TFT_DC, 0);
+    gpio_put(TFT_CS, 0);
+    spi_write_blocking(spi0, &cmd, 1);
+    gpio_put(TFT_CS, 1);
+}
+
+static void old_write_data16(uint16_t data) {
+    uint8_t buf[2] = {data >> 8, data & 0xFF};
+    gpio_put(TFT_DC, 1);
+    gpio_put(TFT_CS, 0);
+    spi_write_blocking(spi0, buf, 2);
+    gpio_put(TFT_CS, 1);
+}
+
+static void old_set_window(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+    old_write_command(0x2A);
+    old_write_data16(x0);
+    old_write_data16(x1);
+    old_write_command(0x2B);
+    old_write_data16(y0);
+    old_write_data16(y1);
+    old_write_command(TFT_CMD_RAMWR);
+}
+
+static void old_fill_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color) {
+    old_set_window(x, y, x + w - 1, y + h - 1);
+
+    gpio_put(TFT_DC, 1);
+    gpio_put(TFT_CS, 0);
+    uint8_t buf[2] = {color >> 8, color & 0xFF};
+    for (uint32_t i = 0; i < (uint32_t)w * h; i++) {
+        spi_write_blocking(spi0, buf, 2);
+    }
+    gpio_put(TFT_CS, 1);
+}
+
+static void old_sprite_push(sprite_t *sprite, uint16_t x, uint16_t y) {
+    old_set_window(x, y, x + sprite->width - 1, y + sprite->height - 1);
+
+    gpio_put(TFT_DC, 1);
+    gpio_put(TFT_CS, 0);
+    for (uint32_t i = 0; i < (uint32_t)sprite->width * sprite->height; i++) {
+        uint8_t buf[2] = {sprite->buffer[i] >> 8, sprite->buffer[i] & 0xFF};
+        spi_write_blocking(spi0, buf, 2);
+    }
+    gpio_put(TFT_CS, 1);
+}
+
+// ===== RUNS =====
+
+typedef struct {
+    uint64_t frame_ns;        // Start to last bit on the wire
+    uint64_t cpu_ns;          // Of that, time the CPU was not just waiting
+    uint32_t calls;           // spi_write_blocking() calls
+    uint64_t bytes;
+    uint32_t hash;
+} run_t;
+
+static sprite_t *sprite;
+
+static void draw(int scene, bool old, uint32_t frame) {
+    uint16_t color = frame & 1 ? COLOR_BLACK : COLOR_WHITE;
+    if (scene == 0) {
+        if (old) old_fill_rect(0, 0, TFT_WIDTH, TFT_HEIGHT, color);
+        else tft_fill_rect(0, 0, TFT_WIDTH, TFT_HEIGHT, color);
+    } else {
+        if (old) old_sprite_push(sprite, 50, 130);
+        else sprite_push(sprite, 50, 130);
+    }
+}
+
+static run_t run(int scene, bool old, uint32_t frames) {
+    wait_bus();
+    uint64_t t0 = now_ns;
+    uint64_t w0 = wait_ns;
+    spi_calls = 0;
+    wire_bytes = 0;
+    pixel_hash = 2166136261u;
+
+    for (uint32_t i = 0; i < frames; i++) {
+        draw(scene, old, i);
+    }
+    wait_bus();
+
+    run_t r = {
+        .frame_ns = (now_ns - t0) / frames,
+        .cpu_ns = (now_ns - t0 - (wait_ns - w0)) / frames,
+        .calls = spi_calls / frames,
+        .bytes = wire_bytes / frames,
+        .hash = pixel_hash,
+    };
+    return r;
+}
+
+static void print_run(const char *scene, const char *path, const run_t *r) {
+    printf("%-14s %-9s %8llu %8u %10.2f %10.1f %8.2f\n", scene, path,
+           (unsigned long long)r->bytes, r->calls, r->frame_ns / 1e6, r->cpu_ns / 1e3,
+           r->bytes * 1000.0 / r->frame_ns);
+}
+
+int main(int argc, char **argv) {
+    uint32_t frames = argc > 1 ? (uint32_t)atoi(argv[1]) : 10;
+    if (frames == 0) frames = 1;
+
+    tft_bus_init();
+    sprite = sprite_create(220, 220);
+    if (!sprite) return 1;
+
+    // Scrambled pixels, so a byte-order slip in either path changes the hash
+    for (uint32_t i = 0; i < 220 * 220; i++) {
+        sprite->buffer[i] = (uint16_t)(i * 2654435761u >> 16);
+    }
+
+    printf("Cost model: %u Hz SPI, %u ns per spi_write_blocking, %u ns per DMA start\n\n",
+           spi0_inst.baud, SPI_CALL_NS, DMA_START_NS);
+    printf("%-14s %-9s %8s %8s %10s %10s %8s\n",
+           "frame", "path", "bytes", "calls", "frame ms", "CPU us", "MB/s");
+
+    static const char *scenes[] = {"fill 320x480", "push 220x220"};
+    bool ok = true;
+    for (int scene = 0; scene < 2; scene++) {
+        run_t old = run(scene, true, frames);
+        run_t dma = run(scene, false, frames);
+        print_run(scenes[scene], "per-pixel", &old);
+        print_run(scenes[scene], "DMA", &dma);
+        printf("%-14s %-9s %28.1fx\n", "", "speedup", (double)old.frame_ns / dma.frame_ns);
+
+        if (old.hash != dma.hash) {
+            printf("%-14s pixels differ between the paths  FAIL\n", scenes[scene]);
+            ok = false;
+        }
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,135 @@
+/**
+ * Lil Guy - Entity Benchmark
+ * Times the entity passes on the host at growing entity counts, with
+ * 16x16 bouncing entities on a panel-sized world, and checks the spatial
+ * hash's collision pairs against a brute-force pass. The world stays the
+ * same size, so crowding grows with the count: move, confine and hash
+ * cost stay flat per entity while collide and hit grow with the number
+ * of neighbours, instead of with the count as brute force does. Every
+ * step's pairs are checked against brute force, which is timed too.
+ *
+ * Usage: lil_guy_entity_bench [steps]
+ */
+
+#include "pico/stdlib.h"
+#include "entity.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_MAX       4096
+#define BENCH_SIZE      16
+#define STEP_US         10000
+
+static uint8_t region[512 * 1024] __attribute__((aligned(ARENA_ALIGN)));
+
+// arena.c asks which core's frame arena to use; there is only one here
+uint get_core_num(void) {
+    return 0;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+// Every overlapping solid pair, the slow way
+static uint32_t brute_pairs(const entity_world_t *world) {
+    uint32_t pairs = 0;
+    for (uint16_t a = 0; a < world->count; a++) {
+        int32_t ax = q16_floor(world->x[a]);
+        int32_t ay = q16_floor(world->y[a]);
+        for (uint16_t b = a + 1; b < world->count; b++) {
+            int32_t bx = q16_floor(world->x[b]);
+            int32_t by = q16_floor(world->y[b]);
+            if (ax < bx + world->w[b] && bx < ax + world->w[a] &&
+                ay < by + world->h[b] && by < ay + world->h[a]) {
+                pairs++;
+            }
+        }
+    }
+    return pairs;
+}
+
+int main(int argc, char **argv) {
+    uint32_t steps = argc > 1 ? (uint32_t)atoi(argv[1]) : 200;
+    if (steps == 0) steps = 1;
+
+    printf("%6s %10s %10s %10s %10s %10s %10s\n",
+           "count", "move", "confine", "hash", "collide", "hit", "brute");
+    printf("%6s %10s %10s %10s %10s %10s %10s\n",
+           "", "ns/ent", "ns/ent", "ns/ent", "ns/ent", "ns/test", "ns/ent");
+
+    bool ok = true;
+    for (uint32_t count = 64; count <= BENCH_MAX; count *= 2) {
+        arena_t arena;
+        arena_init(&arena, region, sizeof(region));
+
+        entity_world_t world;
+        if (!entity_world_init(&world, &arena, count, 320, 480)) {
+            fprintf(stderr, "bench: no room for %u entities\n", count);
+            return 1;
+        }
+
+        srand(count);
+        for (uint32_t i = 0; i < count; i++) {
+            entity_id_t id = entity_spawn(&world, rand() % (320 - BENCH_SIZE),
+                                          rand() % (480 - BENCH_SIZE), BENCH_SIZE, BENCH_SIZE);
+            uint16_t s = entity_slot(&world, id);
+            world.vx[s] = q16_from_int(rand() % 241 - 120);
+            world.vy[s] = q16_from_int(rand() % 241 - 120);
+            world.flags[s] = ENTITY_SOLID | ENTITY_BOUNCE;
+        }
+
+        uint64_t t_move = 0, t_confine = 0, t_hash = 0, t_collide = 0, t_hit = 0, t_brute = 0;
+        for (uint32_t step = 0; step < steps; step++) {
+            uint64_t t0 = now_ns();
+            entity_integrate(&world, STEP_US);
+            uint64_t t1 = now_ns();
+            entity_confine(&world);
+            uint64_t t2 = now_ns();
+            entity_hash_build(&world);
+            uint64_t t3 = now_ns();
+            uint32_t pairs = entity_collide(&world, NULL, NULL);
+            uint64_t t4 = now_ns();
+            for (uint32_t i = 0; i < 16; i++) {
+                entity_hit_test(&world, rand() % 320, rand() % 480);
+            }
+            uint64_t t5 = now_ns();
+            uint32_t expected = brute_pairs(&world);
+            uint64_t t6 = now_ns();
+
+            t_move += t1 - t0;
+            t_confine += t2 - t1;
+            t_hash += t3 - t2;
+            t_collide += t4 - t3;
+            t_hit += t5 - t4;
+            t_brute += t6 - t5;
+
+            // Using the brute-force count keeps its pass from being optimized out
+            if (pairs != expected) {
+                fprintf(stderr, "bench: %u entities, step %u: %u pairs, expected %u\n",
+                        count, step, pairs, expected);
+                ok = false;
+            }
+        }
+
+        // Despawning reorders slots; the rebuilt grid must still agree
+        for (entity_id_t id = 0; id < count; id += 3) {
+            entity_despawn(&world, id);
+        }
+        entity_hash_build(&world);
+        if (entity_collide(&world, NULL, NULL) != brute_pairs(&world)) {
+            fprintf(stderr, "bench: %u entities: pairs wrong after despawning\n", count);
+            ok = false;
+        }
+
+        double per = (double)count * steps;
+        printf("%6u %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n", count,
+               t_move / per, t_confine / per, t_hash / per, t_collide / per,
+               t_hit / (16.0 * steps), t_brute / per);
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,191 @@
+/**
+ * Lil Guy - Fixed-Point Benchmark
+ * Checks fixed.c against libm over the whole input range and times it
+ * against the float versions. On the host the float side has an FPU and
+ * a fast libm, so the timings show relative cost only; on the RP2350 the
+ * float calls go through soft-float libm and the gap is far wider.
+ *
+ * Usage: lil_guy_fixed_bench
+ * Exits non-zero if any result is outside its documented accuracy.
+ */
+
+#include "fixed.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define TIME_CALLS      (1 << 22)
+
+// Error limits from fixed.h
+#define TRIG_MAX_LSB    1
+#define ATAN2_MAX_DEG   0.012
+
+static volatile int64_t sink;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static bool report(const char *name, double worst, double limit, const char *unit) {
+    bool ok = worst <= limit;
+    printf("  %-14s worst %.4f %s (limit %.4f)  %s\n", name, worst, unit, limit, ok ? "ok" : "FAIL");
+    return ok;
+}
+
+// ===== ACCURACY =====
+
+static bool check_trig(void) {
+    int worst_sin = 0;
+    int worst_cos = 0;
+    for (uint32_t a = 0; a < 65536; a++) {
+        double r = a * (2 * M_PI / 65536);
+        int es = abs(fx_sin(a) - (int)lround(sin(r) * Q15_ONE));
+        int ec = abs(fx_cos(a) - (int)lround(cos(r) * Q15_ONE));
+        if (es > worst_sin) worst_sin = es;
+        if (ec > worst_cos) worst_cos = ec;
+    }
+
+    int worst_deg = 0;
+    for (int32_t d = -1080; d <= 1080; d++) {
+        double r = d * (M_PI / 180);
+        int es = abs(fx_sin_deg(d) - (int)lround(sin(r) * Q15_ONE));
+        int ec = abs(fx_cos_deg(d) - (int)lround(cos(r) * Q15_ONE));
+        if (es > worst_deg) worst_deg = es;
+        if (ec > worst_deg) worst_deg = ec;
+    }
+
+    bool ok = report("fx_sin", worst_sin, TRIG_MAX_LSB, "LSB");
+    ok &= report("fx_cos", worst_cos, TRIG_MAX_LSB, "LSB");
+    ok &= report("fx_*_deg", worst_deg, TRIG_MAX_LSB, "LSB");
+    return ok;
+}
+
+static double atan2_error(int32_t y, int32_t x) {
+    double expect = atan2(y, x) * (32768 / M_PI);
+    double diff = fmod(fx_atan2(y, x) - expect, 65536);
+    if (diff > 32768) diff -= 65536;
+    if (diff < -32768) diff += 65536;
+    return fabs(diff) * (360.0 / 65536);
+}
+
+static bool check_atan2(void) {
+    double worst = 0;
+
+    // Every direction on a square ring at a few scales, up to full int32
+    const int32_t scales[] = {1, 7, 100, 1000, 40000, 1 << 20, INT32_MAX / 2};
+    for (uint32_t s = 0; s < sizeof(scales) / sizeof(scales[0]); s++) {
+        int32_t r = scales[s];
+        for (int32_t i = -512; i <= 512; i++) {
+            int32_t t = (int32_t)((int64_t)r * i / 512);
+            double e[4] = {atan2_error(t, r), atan2_error(t, -r), atan2_error(r, t), atan2_error(-r, t)};
+            for (int k = 0; k < 4; k++) {
+                if (e[k] > worst) worst = e[k];
+            }
+        }
+    }
+
+    bool ok = report("fx_atan2", worst, ATAN2_MAX_DEG, "deg");
+    if (fx_atan2(0, 0) != 0) {
+        printf("  fx_atan2(0, 0) != 0  FAIL\n");
+        ok = false;
+    }
+    return ok;
+}
+
+static bool isqrt32_ok(uint32_t v) {
+    return isqrt32(v) == (uint32_t)floor(sqrt((double)v));
+}
+
+static bool check_sqrt(void) {
+    uint32_t bad = 0;
+
+    // Exhaustive below 2^24, then either side of every perfect square
+    for (uint32_t v = 0; v < (1u << 24); v++) {
+        bad += !isqrt32_ok(v);
+    }
+    for (uint32_t k = 4096; k <= 65535; k++) {
+        uint32_t sq = k * k;
+        bad += !isqrt32_ok(sq - 1) + !isqrt32_ok(sq) + !isqrt32_ok(sq + 1);
+    }
+    bad += !isqrt32_ok(UINT32_MAX);
+    printf("  %-14s %u mismatches  %s\n", "isqrt32", bad, bad ? "FAIL" : "ok");
+
+    // isqrt64 around squares across its range
+    uint32_t bad64 = 0;
+    srand(1);
+    for (uint32_t i = 0; i < 1000000; i++) {
+        uint64_t k = ((uint64_t)rand() << 31 | rand()) & 0xFFFFFFFF;
+        uint64_t sq = k * k;
+        bad64 += isqrt64(sq) != k;
+        if (sq) bad64 += isqrt64(sq - 1) != k - 1;
+        if (k < 0xFFFFFFFF) bad64 += isqrt64(sq + 2 * k) != k;
+    }
+    printf("  %-14s %u mismatches  %s\n", "isqrt64", bad64, bad64 ? "FAIL" : "ok");
+
+    // q16_sqrt to within one unit of the rounded-down root
+    uint32_t bad16 = 0;
+    for (q16_t v = 0; v >= 0 && v < INT32_MAX - 9973; v += 9973) {
+        double expect = sqrt(v / 65536.0) * 65536;
+        if (fabs(q16_sqrt(v) - expect) > 1) bad16++;
+    }
+    printf("  %-14s %u mismatches  %s\n", "q16_sqrt", bad16, bad16 ? "FAIL" : "ok");
+
+    return !bad && !bad64 && !bad16;
+}
+
+// ===== TIMING =====
+
+// Same inputs for both sides of each comparison
+static int32_t inputs[TIME_CALLS];
+
+static void time_pair(const char *name, uint64_t fixed_ns, uint64_t float_ns) {
+    printf("  %-14s %6.2f ns  vs %6.2f ns float\n", name,
+           (double)fixed_ns / TIME_CALLS, (double)float_ns / TIME_CALLS);
+}
+
+static void run_timing(void) {
+    srand(2);
+    for (uint32_t i = 0; i < TIME_CALLS; i++) {
+        inputs[i] = rand();
+    }
+
+    int64_t acc = 0;
+    uint64_t t0 = now_ns();
+    for (uint32_t i = 0; i < TIME_CALLS; i++) acc += fx_sin((angle_t)inputs[i]);
+    uint64_t t1 = now_ns();
+    for (uint32_t i = 0; i < TIME_CALLS; i++) acc += (int32_t)(sinf((uint16_t)inputs[i] * (float)(2 * M_PI / 65536)) * Q15_ONE);
+    uint64_t t2 = now_ns();
+    time_pair("sin", t1 - t0, t2 - t1);
+
+    t0 = now_ns();
+    for (uint32_t i = 0; i < TIME_CALLS; i++) acc += fx_atan2(inputs[i] & 0xFFFF, inputs[i] >> 16);
+    t1 = now_ns();
+    for (uint32_t i = 0; i < TIME_CALLS; i++) acc += (int32_t)(atan2f(inputs[i] & 0xFFFF, inputs[i] >> 16) * (float)(32768 / M_PI));
+    t2 = now_ns();
+    time_pair("atan2", t1 - t0, t2 - t1);
+
+    t0 = now_ns();
+    for (uint32_t i = 0; i < TIME_CALLS; i++) acc += isqrt32(inputs[i]);
+    t1 = now_ns();
+    for (uint32_t i = 0; i < TIME_CALLS; i++) acc += (uint32_t)sqrtf((float)inputs[i]);
+    t2 = now_ns();
+    time_pair("isqrt32", t1 - t0, t2 - t1);
+
+    sink = acc;
+}
+
+int main(void) {
+    printf("Accuracy against libm\n");
+    bool ok = check_trig();
+    ok &= check_atan2();
+    ok &= check_sqrt();
+
+    printf("Time per call\n");
+    run_timing();
+
+    return ok ? 0 : 1;
+}
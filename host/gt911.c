@@ -0,0 +1,71 @@
+#include "gt911.h"
+#include "sim.h"
+#include <string.h>
+
+#define REG_SWITCH1     0x804D
+#define REG_STATUS      0x814E
+#define REG_POINT1      0x814F
+#define POINT_SIZE      8
+#define MAX_POINTS      5
+
+// INT falls when a report is ready (SWITCH1 trigger mode 1)
+#define SWITCH1_FALLING 0x01
+
+static struct {
+    bool down;
+    uint16_t x;
+    uint16_t y;
+} contacts[16];
+
+static uint8_t status;
+static uint8_t points[MAX_POINTS * POINT_SIZE];
+
+// Latch the current contacts into the point records, like a scan would
+static void latch_report(void) {
+    memset(points, 0, sizeof(points));
+
+    uint8_t count = 0;
+    for (uint8_t id = 0; id < 16 && count < MAX_POINTS; id++) {
+        if (!contacts[id].down) continue;
+
+        uint8_t *p = &points[count * POINT_SIZE];
+        p[0] = id;
+        p[1] = contacts[id].x & 0xFF;
+        p[2] = contacts[id].x >> 8;
+        p[3] = contacts[id].y & 0xFF;
+        p[4] = contacts[id].y >> 8;
+        p[5] = 20;  // Contact size
+        count++;
+    }
+
+    status = 0x80 | count;
+    hal_gpio_irq(GT911_SIM_INT, 0x04); // GPIO_IRQ_EDGE_FALL
+}
+
+uint8_t gt911_read(uint16_t reg) {
+    if (reg == REG_SWITCH1) return SWITCH1_FALLING;
+    if (reg == REG_STATUS) return status;
+    if (reg >= REG_POINT1 && reg < REG_POINT1 + sizeof(points)) {
+        return points[reg - REG_POINT1];
+    }
+    return 0;
+}
+
+void gt911_write(uint16_t reg, uint8_t value) {
+    // Writing the status register acknowledges the report
+    if (reg == REG_STATUS) status = value;
+}
+
+void gt911_touch(uint8_t id, uint16_t x, uint16_t y) {
+    id &= 0x0F;
+    contacts[id].down = true;
+    contacts[id].x = x;
+    contacts[id].y = y;
+    latch_report();
+}
+
+void gt911_lift(uint8_t id) {
+    id &= 0x0F;
+    contacts[id].down = false;
+    latch_report();
+}
@@ -0,0 +1,18 @@
+#ifndef GT911_H
+#define GT911_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define GT911_SIM_ADDR  0x5D
+#define GT911_SIM_INT   28      // Matches TOUCH_INT in touch.c
+
+// Register file as seen over I2C
+uint8_t gt911_read(uint16_t reg);
+void gt911_write(uint16_t reg, uint8_t value);
+
+// Scripted contacts. Each change latches a new report and pulses INT.
+void gt911_touch(uint8_t id, uint16_t x, uint16_t y);
+void gt911_lift(uint8_t id);
+
+#endif // GT911_H
@@ -0,0 +1,726 @@
+#include "sdk_shim.h"
+#include "sim.h"
+#include "st7796.h"
+#include "gt911.h"
+#include "tft_bus.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NUM_IRQS        64
+#define NUM_DMA         16
+#define MAX_TIMERS      16
+#define MAX_SHARED      4
+
+// ===== VIRTUAL CLOCK =====
+
+// Time only moves when core0 sleeps. Timer callbacks, GPIO interrupts
+// and scripted events all run on core0 at their due time, so a run is
+// deterministic regardless of host speed.
+static uint64_t now_us;
+
+static struct {
+    uint64_t when;
+    repeating_timer_t *timer;
+    async_at_time_worker_t *worker;
+} timers[MAX_TIMERS];
+
+static int add_timer(uint64_t when) {
+    for (int i = 0; i < MAX_TIMERS; i++) {
+        if (!timers[i].timer && !timers[i].worker) {
+            timers[i].when = when;
+            return i;
+        }
+    }
+    fprintf(stderr, "sim: out of timers\n");
+    abort();
+}
+
+static void fire_timer(int i) {
+    if (timers[i].timer) {
+        repeating_timer_t *rt = timers[i].timer;
+        if (rt->callback(rt)) {
+            timers[i].when += rt->delay_us < 0 ? -rt->delay_us : rt->delay_us;
+        } else {
+            timers[i].timer = NULL;
+        }
+    } else {
+        // One-shot; the worker may add itself again
+        async_at_time_worker_t *worker = timers[i].worker;
+        timers[i].worker = NULL;
+        worker->do_work(cyw43_arch_async_context(), worker);
+    }
+}
+
+// Run everything due up to and including target, in time order
+static void run_until(uint64_t target) {
+    while (true) {
+        int first = -1;
+        for (int i = 0; i < MAX_TIMERS; i++) {
+            if ((timers[i].timer || timers[i].worker) &&
+                (first < 0 || timers[i].when < timers[first].when)) {
+                first = i;
+            }
+        }
+
+        uint64_t timer_at = first >= 0 ? timers[first].when : UINT64_MAX;
+        uint64_t event_at = sim_next_event_us();
+        uint64_t next = timer_at < event_at ? timer_at : event_at;
+        if (next > target) break;
+
+        if (next > now_us) now_us = next;
+        if (event_at <= timer_at) {
+            sim_run_event();
+        } else {
+            fire_timer(first);
+        }
+    }
+
+    if (target > now_us) now_us = target;
+}
+
+// ===== CORES =====
+
+// Core1 runs on its own thread. __wfe/__sev keep the ARM event-register
+// semantics; core0 waits for core1 to go idle before moving the clock.
+static pthread_t core1_thread;
+static pthread_mutex_t core_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t core_cond = PTHREAD_COND_INITIALIZER;
+static bool core1_running;
+static bool core1_waiting;
+static bool event_flag;
+
+static void *core1_entry(void *arg) {
+    void (*entry)(void) = (void (*)(void))arg;
+    entry();
+    return NULL;
+}
+
+void multicore_launch_core1(void (*entry)(void)) {
+    core1_running = true;
+    pthread_create(&core1_thread, NULL, core1_entry, (void *)entry);
+}
+
+uint get_core_num(void) {
+    return core1_running && pthread_equal(pthread_self(), core1_thread) ? 1 : 0;
+}
+
+void __wfe(void) {
+    pthread_mutex_lock(&core_lock);
+    if (!event_flag) {
+        core1_waiting = true;
+        pthread_cond_broadcast(&core_cond);
+        while (!event_flag) {
+            pthread_cond_wait(&core_cond, &core_lock);
+        }
+        core1_waiting = false;
+    }
+    event_flag = false;
+    pthread_mutex_unlock(&core_lock);
+}
+
+void __sev(void) {
+    pthread_mutex_lock(&core_lock);
+    event_flag = true;
+    pthread_cond_broadcast(&core_cond);
+    pthread_mutex_unlock(&core_lock);
+}
+
+static void wait_core1_idle(void) {
+    if (!core1_running) return;
+
+    pthread_mutex_lock(&core_lock);
+    while (!core1_waiting || event_flag) {
+        pthread_cond_wait(&core_cond, &core_lock);
+    }
+    pthread_mutex_unlock(&core_lock);
+}
+
+// ===== TIME =====
+
+uint64_t time_us_64(void) {
+    return now_us;
+}
+
+uint32_t time_us_32(void) {
+    return (uint32_t)now_us;
+}
+
+absolute_time_t get_absolute_time(void) {
+    return now_us;
+}
+
+uint32_t to_ms_since_boot(absolute_time_t t) {
+    return (uint32_t)(t / 1000);
+}
+
+uint64_t to_us_since_boot(absolute_time_t t) {
+    return t;
+}
+
+absolute_time_t from_us_since_boot(uint64_t us) {
+    return us;
+}
+
+void sleep_us(uint64_t us) {
+    wait_core1_idle();
+    run_until(now_us + us);
+}
+
+void sleep_ms(uint32_t ms) {
+    sleep_us((uint64_t)ms * 1000);
+}
+
+// The scheduler is the only caller, so this marks a frame boundary
+void sleep_until(absolute_time_t t) {
+    wait_core1_idle();
+    sim_frame_end();
+    run_until(t);
+}
+
+// Raw bytes (trace packets) go to their own file so the console stays
+// readable; without one they are dropped
+static FILE *usb_capture;
+
+void hal_set_usb_capture(FILE *f) {
+    usb_capture = f;
+}
+
+bool stdio_init_all(void) {
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    return true;
+}
+
+int putchar_raw(int c) {
+    if (usb_capture) fputc(c, usb_capture);
+    return c;
+}
+
+bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t callback,
+                            void *user_data, repeating_timer_t *out) {
+    out->delay_us = delay_us;
+    out->callback = callback;
+    out->user_data = user_data;
+
+    int i = add_timer(now_us + (delay_us < 0 ? -delay_us : delay_us));
+    timers[i].timer = out;
+    return true;
+}
+
+bool add_repeating_timer_ms(int32_t delay_ms, repeating_timer_callback_t callback,
+                            void *user_data, repeating_timer_t *out) {
+    return add_repeating_timer_us((int64_t)delay_ms * 1000, callback, user_data, out);
+}
+
+// ===== IRQ =====
+
+static bool irq_enabled[NUM_IRQS];
+static irq_handler_t shared_handlers[NUM_IRQS][MAX_SHARED];
+
+void irq_set_enabled(uint num, bool enabled) {
+    irq_enabled[num] = enabled;
+}
+
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority) {
+    for (int i = 0; i < MAX_SHARED; i++) {
+        if (!shared_handlers[num][i]) {
+            shared_handlers[num][i] = handler;
+            return;
+        }
+    }
+}
+
+static void raise_irq(uint num) {
+    if (!irq_enabled[num]) return;
+
+    for (int i = 0; i < MAX_SHARED && shared_handlers[num][i]; i++) {
+        shared_handlers[num][i]();
+    }
+}
+
+// ===== GPIO =====
+
+static uint32_t dir_out;
+static uint32_t out_level;
+static uint32_t in_level = 0xFFFFFFFFu;
+
+static irq_handler_t gpio_handlers[32];
+static uint32_t gpio_irq_mask[32];
+static uint32_t gpio_irq_pending[32];
+
+void gpio_init(uint gpio) {
+    dir_out &= ~(1u << gpio);
+    out_level &= ~(1u << gpio);
+}
+
+void gpio_init_mask(uint32_t mask) {
+    dir_out &= ~mask;
+    out_level &= ~mask;
+}
+
+void gpio_set_dir(uint gpio, bool out) {
+    if (out) {
+        dir_out |= 1u << gpio;
+    } else {
+        dir_out &= ~(1u << gpio);
+    }
+}
+
+void gpio_set_dir_in_masked(uint32_t mask) {
+    dir_out &= ~mask;
+}
+
+void gpio_set_function(uint gpio, uint fn) {
+}
+
+void gpio_pull_up(uint gpio) {
+}
+
+void gpio_put(uint gpio, bool value) {
+    if (value) {
+        out_level |= 1u << gpio;
+    } else {
+        out_level &= ~(1u << gpio);
+    }
+}
+
+uint32_t gpio_get_all(void) {
+    return (in_level & ~dir_out) | (out_level & dir_out);
+}
+
+bool gpio_get(uint gpio) {
+    return (gpio_get_all() >> gpio) & 1;
+}
+
+void gpio_set_irq_enabled(uint gpio, uint32_t event_mask, bool enabled) {
+    if (enabled) {
+        gpio_irq_mask[gpio] |= event_mask;
+    } else {
+        gpio_irq_mask[gpio] &= ~event_mask;
+    }
+}
+
+void gpio_add_raw_irq_handler(uint gpio, irq_handler_t handler) {
+    gpio_handlers[gpio] = handler;
+}
+
+uint32_t gpio_get_irq_event_mask(uint gpio) {
+    return gpio_irq_pending[gpio];
+}
+
+void gpio_acknowledge_irq(uint gpio, uint32_t event_mask) {
+    gpio_irq_pending[gpio] &= ~event_mask;
+}
+
+void hal_set_input(unsigned gpio, bool level) {
+    if (level) {
+        in_level |= 1u << gpio;
+    } else {
+        in_level &= ~(1u << gpio);
+    }
+}
+
+void hal_gpio_irq(unsigned gpio, uint32_t events) {
+    gpio_irq_pending[gpio] |= events & gpio_irq_mask[gpio];
+    if (gpio_irq_pending[gpio] && irq_enabled[IO_IRQ_BANK0] && gpio_handlers[gpio]) {
+        gpio_handlers[gpio]();
+    }
+}
+
+// ===== SPI =====
+
+struct spi_inst {
+    spi_hw_t hw;
+    uint baud;
+    uint data_bits;
+};
+
+static struct spi_inst spi0_inst = {.data_bits = 8};
+spi_inst_t *const spi0 = &spi0_inst;
+
+// Bytes only reach the panel while it is selected
+static void spi_send(uint8_t byte) {
+    if (out_level & (1u << TFT_CS)) return;
+    st7796_write(byte, out_level & (1u << TFT_DC));
+}
+
+uint spi_init(spi_inst_t *spi, uint baudrate) {
+    spi->baud = baudrate;
+    return baudrate;
+}
+
+void spi_set_format(spi_inst_t *spi, uint data_bits, spi_cpol_t cpol, spi_cpha_t cpha, spi_order_t order) {
+    spi->data_bits = data_bits;
+}
+
+int spi_write_blocking(spi_inst_t *spi, const uint8_t *src, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        spi_send(src[i]);
+    }
+    return (int)len;
+}
+
+bool spi_is_busy(const spi_inst_t *spi) {
+    return false;
+}
+
+spi_hw_t *spi_get_hw(spi_inst_t *spi) {
+    return &spi->hw;
+}
+
+uint spi_get_dreq(spi_inst_t *spi, bool is_tx) {
+    return is_tx ? 24 : 25;
+}
+
+uint32_t hal_spi_baud(void) {
+    return spi0_inst.baud;
+}
+
+// ===== I2C =====
+
+struct i2c_inst {
+    i2c_hw_t hw;
+};
+
+static struct i2c_inst i2c0_inst;
+i2c_inst_t *const i2c0 = &i2c0_inst;
+
+static uint16_t i2c_reg;
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) {
+    return baudrate;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    if (addr != GT911_SIM_ADDR) return -2; // PICO_ERROR_GENERIC
+
+    // Two address bytes, then register writes
+    for (size_t i = 0; i < len; i++) {
+        if (i < 2) {
+            i2c_reg = (i2c_reg << 8) | src[i];
+        } else {
+            gt911_write(i2c_reg++, src[i]);
+        }
+    }
+    return (int)len;
+}
+
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop) {
+    if (addr != GT911_SIM_ADDR) return -2;
+
+    for (size_t i = 0; i < len; i++) {
+        dst[i] = gt911_read(i2c_reg++);
+    }
+    return (int)len;
+}
+
+i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c) {
+    return &i2c->hw;
+}
+
+uint i2c_get_dreq(i2c_inst_t *i2c, bool is_tx) {
+    return is_tx ? 44 : 45;
+}
+
+// ===== ADC =====
+
+static adc_hw_t adc_regs;
+adc_hw_t *const adc_hw = &adc_regs;
+
+static uint16_t adc_values[2] = {2048, 2048};
+static int adc_chan = -1;
+
+void adc_init(void) {}
+void adc_gpio_init(uint gpio) {}
+void adc_select_input(uint input) {}
+void adc_set_round_robin(uint input_mask) {}
+void adc_fifo_setup(bool en, bool dreq_en, uint16_t dreq_thresh, bool err_in_fifo, bool byte_shift) {}
+void adc_set_clkdiv(float clkdiv) {}
+void adc_run(bool run) {}
+
+// ===== DMA =====
+
+// Transfers complete the moment they are triggered. Three destinations
+// are modelled: the display SPI, the touch I2C command stream and the
+// ADC FIFO ring; anything else (the audio PWM) is accepted and dropped.
+typedef struct {
+    bool claimed;
+    dma_channel_config config;
+    volatile void *write_addr;
+    const volatile void *read_addr;
+    uint32_t count;
+    bool busy;
+    bool irq1_enabled;
+    bool irq1_status;
+} dma_channel_t;
+
+static dma_channel_t channels[NUM_DMA];
+static dma_hw_t dma_regs;
+dma_hw_t *const dma_hw = &dma_regs;
+static int dma_timers_claimed;
+
+// Refill the whole ring with the current readings, interleaved as the
+// round-robin would write them
+static void adc_fill(void) {
+    if (adc_chan < 0) return;
+
+    dma_channel_t *ch = &channels[adc_chan];
+    uint32_t ring_bytes = ch->config.ring_bits ? 1u << ch->config.ring_bits : 2;
+    uint16_t *ring = (uint16_t *)((uintptr_t)ch->write_addr & ~(uintptr_t)(ring_bytes - 1));
+    for (uint32_t i = 0; i < ring_bytes / 2; i++) {
+        ring[i] = adc_values[i & 1];
+    }
+}
+
+void hal_set_adc(uint16_t adc0, uint16_t adc1) {
+    adc_values[0] = adc0;
+    adc_values[1] = adc1;
+    adc_fill();
+}
+
+static void dma_complete(uint channel) {
+    dma_channel_t *ch = &channels[channel];
+    ch->busy = false;
+    ch->count = 0;
+    if (ch->irq1_enabled) {
+        ch->irq1_status = true;
+        raise_irq(DMA_IRQ_1);
+    }
+}
+
+static void dma_to_spi(dma_channel_t *ch) {
+    const volatile uint8_t *src = ch->read_addr;
+    uint8_t size = 1u << ch->config.size;
+
+    for (uint32_t i = 0; i < ch->count; i++) {
+        uint32_t v = size == 1 ? src[0] : size == 2 ? *(const uint16_t *)src : *(const uint32_t *)src;
+        if (spi0_inst.data_bits > 8) {
+            spi_send(v >> 8);
+        }
+        spi_send(v & 0xFF);
+        if (ch->config.read_increment) src += size;
+    }
+}
+
+// Play a DW_apb_i2c command stream against the GT911 and deliver the
+// read bytes to whichever channel is draining the RX FIFO
+static void dma_to_i2c(dma_channel_t *tx) {
+    dma_channel_t *rx = NULL;
+    uint rx_index = 0;
+    for (uint i = 0; i < NUM_DMA; i++) {
+        if (channels[i].busy && channels[i].read_addr == &i2c0_inst.hw.data_cmd) {
+            rx = &channels[i];
+            rx_index = i;
+        }
+    }
+
+    // No device at the target address: nothing comes back
+    if (i2c0_inst.hw.tar != GT911_SIM_ADDR) return;
+
+    const volatile uint32_t *cmds = tx->read_addr;
+    volatile uint8_t *dst = rx ? rx->write_addr : NULL;
+    uint8_t addr_bytes = 0;
+
+    for (uint32_t i = 0; i < tx->count; i++) {
+        uint32_t cmd = cmds[i];
+        if (cmd & I2C_IC_DATA_CMD_CMD_BITS) {
+            uint8_t byte = gt911_read(i2c_reg++);
+            if (rx && rx->count) {
+                *dst++ = byte;
+                rx->count--;
+            }
+        } else if (addr_bytes < 2) {
+            i2c_reg = (i2c_reg << 8) | (cmd & 0xFF);
+            addr_bytes++;
+        } else {
+            gt911_write(i2c_reg++, cmd & 0xFF);
+        }
+    }
+
+    if (rx && rx->count == 0) {
+        dma_complete(rx_index);
+    }
+}
+
+static void dma_trigger(uint channel) {
+    dma_channel_t *ch = &channels[channel];
+    ch->busy = true;
+
+    if (ch->write_addr == &spi0_inst.hw.dr) {
+        dma_to_spi(ch);
+        dma_complete(channel);
+    } else if (ch->write_addr == &i2c0_inst.hw.data_cmd) {
+        dma_to_i2c(ch);
+        dma_complete(channel);
+    } else if (ch->read_addr == &adc_regs.fifo) {
+        // Free-running: stays busy and is refilled as readings change
+        adc_chan = channel;
+        adc_fill();
+    } else if (ch->read_addr == &i2c0_inst.hw.data_cmd) {
+        // RX side waits for the matching TX stream
+    } else {
+        ch->busy = false;
+    }
+}
+
+int dma_claim_unused_channel(bool required) {
+    for (int i = 0; i < NUM_DMA; i++) {
+        if (!channels[i].claimed) {
+            channels[i].claimed = true;
+            return i;
+        }
+    }
+    if (required) {
+        fprintf(stderr, "sim: out of DMA channels\n");
+        abort();
+    }
+    return -1;
+}
+
+dma_channel_config dma_channel_get_default_config(uint channel) {
+    dma_channel_config c = {
+        .size = DMA_SIZE_32,
+        .read_increment = true,
+        .write_increment = false,
+        .chain_to = (int)channel,
+    };
+    return c;
+}
+
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size) {
+    c->size = size;
+}
+
+void channel_config_set_read_increment(dma_channel_config *c, bool incr) {
+    c->read_increment = incr;
+}
+
+void channel_config_set_write_increment(dma_channel_config *c, bool incr) {
+    c->write_increment = incr;
+}
+
+void channel_config_set_dreq(dma_channel_config *c, uint dreq) {
+    c->dreq = dreq;
+}
+
+void channel_config_set_chain_to(dma_channel_config *c, uint chain_to) {
+    c->chain_to = (int)chain_to;
+}
+
+void channel_config_set_ring(dma_channel_config *c, bool write, uint size_bits) {
+    c->ring_write = write;
+    c->ring_bits = size_bits;
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint32_t transfer_count, bool trigger) {
+    dma_channel_t *ch = &channels[channel];
+    ch->config = *config;
+    ch->write_addr = write_addr;
+    ch->read_addr = read_addr;
+    ch->count = transfer_count;
+    if (trigger) dma_trigger(channel);
+}
+
+void dma_channel_set_read_addr(uint channel, const volatile void *read_addr, bool trigger) {
+    channels[channel].read_addr = read_addr;
+    if (trigger) dma_trigger(channel);
+}
+
+void dma_channel_set_write_addr(uint channel, volatile void *write_addr, bool trigger) {
+    channels[channel].write_addr = write_addr;
+    if (trigger) dma_trigger(channel);
+}
+
+void dma_channel_set_trans_count(uint channel, uint32_t trans_count, bool trigger) {
+    channels[channel].count = trans_count;
+    if (trigger) dma_trigger(channel);
+}
+
+void dma_channel_start(uint channel) {
+    dma_trigger(channel);
+}
+
+void dma_channel_abort(uint channel) {
+    channels[channel].busy = false;
+}
+
+bool dma_channel_is_busy(uint channel) {
+    return channels[channel].busy;
+}
+
+void dma_channel_wait_for_finish_blocking(uint channel) {
+    // Only free-running channels stay busy, and nobody waits on those
+}
+
+void dma_channel_set_irq1_enabled(uint channel, bool enabled) {
+    channels[channel].irq1_enabled = enabled;
+}
+
+bool dma_channel_get_irq1_status(uint channel) {
+    return channels[channel].irq1_status;
+}
+
+void dma_channel_acknowledge_irq1(uint channel) {
+    channels[channel].irq1_status = false;
+}
+
+int dma_claim_unused_timer(bool required) {
+    return dma_timers_claimed++;
+}
+
+void dma_timer_set_fraction(uint timer, uint16_t numerator, uint16_t denominator) {}
+
+uint dma_get_timer_dreq(uint timer) {
+    return 59 + timer;
+}
+
+// ===== PWM / CLOCKS =====
+
+static pwm_hw_t pwm_regs;
+pwm_hw_t *const pwm_hw = &pwm_regs;
+
+uint pwm_gpio_to_slice_num(uint gpio) {
+    return (gpio >> 1) & 7;
+}
+
+uint pwm_gpio_to_channel(uint gpio) {
+    return gpio & 1;
+}
+
+void pwm_set_wrap(uint slice, uint16_t wrap) {}
+void pwm_set_clkdiv(uint slice, float divider) {}
+void pwm_set_gpio_level(uint gpio, uint16_t level) {}
+void pwm_set_enabled(uint slice, bool enabled) {}
+
+uint32_t clock_get_hz(enum clock_index clk) {
+    return 150000000;
+}
+
+// ===== CYW43 / ASYNC CONTEXT =====
+
+struct async_context {
+    bool wl_led;
+};
+
+static async_context_t wl_context;
+
+int cyw43_arch_init(void) {
+    return 0;
+}
+
+void cyw43_arch_gpio_put(uint wl_gpio, bool value) {
+    wl_context.wl_led = value;
+}
+
+async_context_t *cyw43_arch_async_context(void) {
+    return &wl_context;
+}
+
+bool async_context_add_at_time_worker_in_ms(async_context_t *context, async_at_time_worker_t *worker,
+                                            uint32_t ms) {
+    int i = add_timer(now_us + (uint64_t)ms * 1000);
+    timers[i].worker = worker;
+    worker->next_time = timers[i].when;
+    return true;
+}
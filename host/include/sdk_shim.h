@@ -0,0 +1,263 @@
+#ifndef SDK_SHIM_H
+#define SDK_SHIM_H
+
+// Host stand-in for the parts of the Pico SDK the firmware uses. The
+// pico/ and hardware/ headers next to this one all include it, so the
+// firmware sources compile unchanged. Behaviour lives in hal.c.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+typedef unsigned int uint;
+
+// ===== TIME =====
+
+typedef uint64_t absolute_time_t;
+
+uint64_t time_us_64(void);
+uint32_t time_us_32(void);
+absolute_time_t get_absolute_time(void);
+uint32_t to_ms_since_boot(absolute_time_t t);
+uint64_t to_us_since_boot(absolute_time_t t);
+absolute_time_t from_us_since_boot(uint64_t us);
+
+void sleep_ms(uint32_t ms);
+void sleep_us(uint64_t us);
+void sleep_until(absolute_time_t t);
+
+static inline void tight_loop_contents(void) {}
+
+bool stdio_init_all(void);
+
+// Raw USB CDC output; the simulator sends it to the -T capture file
+int putchar_raw(int c);
+
+// ===== TIMERS =====
+
+typedef struct repeating_timer repeating_timer_t;
+typedef bool (*repeating_timer_callback_t)(repeating_timer_t *rt);
+
+struct repeating_timer {
+    int64_t delay_us;
+    repeating_timer_callback_t callback;
+    void *user_data;
+};
+
+bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t callback,
+                            void *user_data, repeating_timer_t *out);
+bool add_repeating_timer_ms(int32_t delay_ms, repeating_timer_callback_t callback,
+                            void *user_data, repeating_timer_t *out);
+
+// ===== IRQ / SYNC =====
+
+typedef void (*irq_handler_t)(void);
+
+#define IO_IRQ_BANK0    21
+#define DMA_IRQ_0       10
+#define DMA_IRQ_1       11
+#define PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY 0x80
+
+void irq_set_enabled(uint num, bool enabled);
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority);
+
+void __wfe(void);
+void __sev(void);
+static inline void __dmb(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline uint32_t save_and_disable_interrupts(void) { return 0; }
+static inline void restore_interrupts(uint32_t status) { (void)status; }
+
+void multicore_launch_core1(void (*entry)(void));
+uint get_core_num(void);
+
+// ===== GPIO =====
+
+#define GPIO_OUT 1
+#define GPIO_IN  0
+
+enum gpio_function {
+    GPIO_FUNC_SPI = 1,
+    GPIO_FUNC_UART = 2,
+    GPIO_FUNC_I2C = 3,
+    GPIO_FUNC_PWM = 4,
+    GPIO_FUNC_SIO = 5,
+    GPIO_FUNC_PIO0 = 6,
+    GPIO_FUNC_PIO1 = 7,
+    GPIO_FUNC_NULL = 0x1f
+};
+
+enum gpio_irq_level {
+    GPIO_IRQ_LEVEL_LOW = 1,
+    GPIO_IRQ_LEVEL_HIGH = 2,
+    GPIO_IRQ_EDGE_FALL = 4,
+    GPIO_IRQ_EDGE_RISE = 8
+};
+
+void gpio_init(uint gpio);
+void gpio_init_mask(uint32_t mask);
+void gpio_set_dir(uint gpio, bool out);
+void gpio_set_dir_in_masked(uint32_t mask);
+void gpio_set_function(uint gpio, uint fn);
+void gpio_pull_up(uint gpio);
+void gpio_put(uint gpio, bool value);
+bool gpio_get(uint gpio);
+uint32_t gpio_get_all(void);
+
+void gpio_set_irq_enabled(uint gpio, uint32_t event_mask, bool enabled);
+void gpio_add_raw_irq_handler(uint gpio, irq_handler_t handler);
+uint32_t gpio_get_irq_event_mask(uint gpio);
+void gpio_acknowledge_irq(uint gpio, uint32_t event_mask);
+
+// ===== SPI =====
+
+typedef struct {
+    volatile uint32_t cr0, cr1, dr, sr;
+} spi_hw_t;
+
+typedef struct spi_inst spi_inst_t;
+extern spi_inst_t *const spi0;
+
+typedef enum { SPI_CPOL_0, SPI_CPOL_1 } spi_cpol_t;
+typedef enum { SPI_CPHA_0, SPI_CPHA_1 } spi_cpha_t;
+typedef enum { SPI_LSB_FIRST, SPI_MSB_FIRST } spi_order_t;
+
+uint spi_init(spi_inst_t *spi, uint baudrate);
+void spi_set_format(spi_inst_t *spi, uint data_bits, spi_cpol_t cpol, spi_cpha_t cpha, spi_order_t order);
+int spi_write_blocking(spi_inst_t *spi, const uint8_t *src, size_t len);
+bool spi_is_busy(const spi_inst_t *spi);
+spi_hw_t *spi_get_hw(spi_inst_t *spi);
+uint spi_get_dreq(spi_inst_t *spi, bool is_tx);
+
+// ===== I2C =====
+
+typedef struct {
+    volatile uint32_t enable, tar, data_cmd, clr_tx_abrt;
+} i2c_hw_t;
+
+typedef struct i2c_inst i2c_inst_t;
+extern i2c_inst_t *const i2c0;
+
+#define I2C_IC_DATA_CMD_CMD_BITS     0x00000100
+#define I2C_IC_DATA_CMD_STOP_BITS    0x00000200
+#define I2C_IC_DATA_CMD_RESTART_BITS 0x00000400
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate);
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop);
+i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c);
+uint i2c_get_dreq(i2c_inst_t *i2c, bool is_tx);
+
+// ===== DMA =====
+
+enum dma_channel_transfer_size {
+    DMA_SIZE_8 = 0,
+    DMA_SIZE_16 = 1,
+    DMA_SIZE_32 = 2
+};
+
+#define DREQ_ADC 48
+
+typedef struct {
+    uint8_t size;
+    bool read_increment;
+    bool write_increment;
+    bool ring_write;
+    uint8_t ring_bits;
+    uint dreq;
+    int chain_to;
+} dma_channel_config;
+
+typedef struct {
+    struct {
+        volatile uint32_t read_addr, write_addr, transfer_count, ctrl_trig;
+        volatile uint32_t al1_ctrl, al1_read_addr, al1_write_addr, al1_transfer_count_trig;
+    } ch[16];
+} dma_hw_t;
+
+extern dma_hw_t *const dma_hw;
+
+int dma_claim_unused_channel(bool required);
+dma_channel_config dma_channel_get_default_config(uint channel);
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size);
+void channel_config_set_read_increment(dma_channel_config *c, bool incr);
+void channel_config_set_write_increment(dma_channel_config *c, bool incr);
+void channel_config_set_dreq(dma_channel_config *c, uint dreq);
+void channel_config_set_chain_to(dma_channel_config *c, uint chain_to);
+void channel_config_set_ring(dma_channel_config *c, bool write, uint size_bits);
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint32_t transfer_count, bool trigger);
+void dma_channel_set_read_addr(uint channel, const volatile void *read_addr, bool trigger);
+void dma_channel_set_write_addr(uint channel, volatile void *write_addr, bool trigger);
+void dma_channel_set_trans_count(uint channel, uint32_t trans_count, bool trigger);
+void dma_channel_start(uint channel);
+void dma_channel_abort(uint channel);
+bool dma_channel_is_busy(uint channel);
+void dma_channel_wait_for_finish_blocking(uint channel);
+
+void dma_channel_set_irq1_enabled(uint channel, bool enabled);
+bool dma_channel_get_irq1_status(uint channel);
+void dma_channel_acknowledge_irq1(uint channel);
+
+int dma_claim_unused_timer(bool required);
+void dma_timer_set_fraction(uint timer, uint16_t numerator, uint16_t denominator);
+uint dma_get_timer_dreq(uint timer);
+
+// ===== ADC =====
+
+typedef struct {
+    volatile uint32_t cs, result, fcs, fifo, div;
+} adc_hw_t;
+
+extern adc_hw_t *const adc_hw;
+
+void adc_init(void);
+void adc_gpio_init(uint gpio);
+void adc_select_input(uint input);
+void adc_set_round_robin(uint input_mask);
+void adc_fifo_setup(bool en, bool dreq_en, uint16_t dreq_thresh, bool err_in_fifo, bool byte_shift);
+void adc_set_clkdiv(float clkdiv);
+void adc_run(bool run);
+
+// ===== PWM / CLOCKS =====
+
+typedef struct {
+    struct {
+        volatile uint32_t csr, div, ctr, cc, top;
+    } slice[12];
+} pwm_hw_t;
+
+extern pwm_hw_t *const pwm_hw;
+
+uint pwm_gpio_to_slice_num(uint gpio);
+uint pwm_gpio_to_channel(uint gpio);
+void pwm_set_wrap(uint slice, uint16_t wrap);
+void pwm_set_clkdiv(uint slice, float divider);
+void pwm_set_gpio_level(uint gpio, uint16_t level);
+void pwm_set_enabled(uint slice, bool enabled);
+
+enum clock_index { clk_sys = 5 };
+uint32_t clock_get_hz(enum clock_index clk);
+
+// ===== CYW43 / ASYNC CONTEXT =====
+
+typedef struct async_context async_context_t;
+typedef struct async_work_on_timeout async_at_time_worker_t;
+
+struct async_work_on_timeout {
+    async_at_time_worker_t *next;
+    void (*do_work)(async_context_t *context, async_at_time_worker_t *worker);
+    absolute_time_t next_time;
+    void *user_data;
+};
+
+#define CYW43_WL_GPIO_LED_PIN 0
+
+int cyw43_arch_init(void);
+void cyw43_arch_gpio_put(uint wl_gpio, bool value);
+async_context_t *cyw43_arch_async_context(void);
+bool async_context_add_at_time_worker_in_ms(async_context_t *context, async_at_time_worker_t *worker,
+                                            uint32_t ms);
+
+#endif // SDK_SHIM_H
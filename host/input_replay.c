@@ -0,0 +1,183 @@
+/**
+ * Lil Guy - Input Debounce Replay
+ * Feeds switch bounce waveforms through input.c's vertical-counter
+ * debouncer on a virtual clock, at several phases against the 1 ms scan,
+ * and checks the events that come out: how many of each type, and how
+ * long after the first physical edge each press and release is queued.
+ *
+ * Usage: lil_guy_input_replay
+ * Exits non-zero if any trace produces the wrong events or is too slow.
+ */
+
+#include "pico/stdlib.h"
+#include "hardware/gpio.h"
+#include "input.h"
+#include <stdio.h>
+
+#define BUTTON          15
+
+// A change must hold for four samples; the first of them can come up to
+// one scan after the line settles
+#define SETTLE_SAMPLES  4
+
+// Virtual hardware: the clock, the button line and the scan timer
+static uint64_t now_us;
+static bool pressed;
+static repeating_timer_t *scan;
+
+uint64_t time_us_64(void) {
+    return now_us;
+}
+
+uint32_t gpio_get_all(void) {
+    // Active low with pull-ups: everything else reads high
+    return pressed ? ~(1u << BUTTON) : ~0u;
+}
+
+void gpio_init_mask(uint32_t mask) {}
+void gpio_set_dir_in_masked(uint32_t mask) {}
+void gpio_pull_up(uint gpio) {}
+
+bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t callback,
+                            void *user_data, repeating_timer_t *out) {
+    out->delay_us = delay_us;
+    out->callback = callback;
+    out->user_data = user_data;
+    scan = out;
+    return true;
+}
+
+// ===== TRACES =====
+
+// Times the line changes level, starting with a press at 0 us. Captured
+// shapes of tactile switch bounce: contacts chatter for a few hundred
+// microseconds to several milliseconds on make and break.
+typedef struct {
+    const char *name;
+    uint32_t edges[16];
+    uint8_t edge_count;
+    uint8_t presses;          // Expected events
+    uint8_t releases;
+    uint8_t min_repeats;
+    uint8_t max_repeats;
+} trace_t;
+
+static const trace_t traces[] = {
+    {"clean tap",         {0, 80000}, 2, 1, 1, 0, 0},
+    {"make bounce",       {0, 300, 700, 1500, 1800, 80000}, 6, 1, 1, 0, 0},
+    {"break bounce",      {0, 80000, 80250, 80600, 81400, 81700}, 6, 1, 1, 0, 0},
+    {"both bounce",       {0, 150, 400, 900, 1300, 2100, 2400,
+                           60000, 60200, 60700, 61000, 61900, 62300, 63800}, 14, 1, 1, 0, 0},
+    {"5 ms chatter",      {0, 400, 900, 1600, 2000, 2700, 3300, 3900, 4500, 50000}, 10, 1, 1, 0, 0},
+    {"1.5 ms glitch",     {0, 1500}, 2, 0, 0, 0, 0},
+    {"2.9 ms glitch",     {0, 2900}, 2, 0, 0, 0, 0},
+    {"bouncy glitch",     {0, 600, 1100, 2500}, 4, 0, 0, 0, 0},
+    {"1 s hold",          {0, 1000000}, 2, 1, 1, 6, 7},
+};
+
+// Phases of the trace against the scan timer
+static const uint32_t phases[] = {0, 1, 250, 500, 999};
+
+// ===== REPLAY =====
+
+typedef struct {
+    uint32_t presses;
+    uint32_t releases;
+    uint32_t repeats;
+    uint32_t worst_press_us;  // From the first edge of a change to its event
+    uint32_t worst_release_us;
+} replay_result_t;
+
+static bool replay(const trace_t *trace, uint32_t phase, replay_result_t *out) {
+    *out = (replay_result_t){0};
+
+    // Scans keep their phase across traces; start this one so the first
+    // edge lands `phase` us after a scan
+    uint64_t start = (now_us / INPUT_SCAN_US + 1) * INPUT_SCAN_US + phase;
+    uint64_t end = start + trace->edges[trace->edge_count - 1] + 50000;
+    uint8_t next_edge = 0;
+    uint64_t press_edge = start;
+    uint64_t release_edge = start;
+
+    for (uint64_t t = now_us - now_us % INPUT_SCAN_US + INPUT_SCAN_US; t < end; t += INPUT_SCAN_US) {
+        // Apply every edge up to this scan
+        while (next_edge < trace->edge_count && start + trace->edges[next_edge] <= t) {
+            uint64_t edge = start + trace->edges[next_edge];
+            pressed = !(next_edge & 1);
+
+            // First edge of a press or release, after the line was steady
+            if (next_edge == 0 || edge - (start + trace->edges[next_edge - 1]) > SETTLE_SAMPLES * INPUT_SCAN_US) {
+                if (pressed) press_edge = edge;
+                else release_edge = edge;
+            }
+            next_edge++;
+        }
+
+        now_us = t;
+        scan->callback(scan);
+
+        input_event_t event;
+        while (input_poll_event(&event)) {
+            if (event.gpio != BUTTON) return false;
+            if (event.type == INPUT_PRESS) {
+                uint32_t latency = (uint32_t)(t - press_edge);
+                if (latency > out->worst_press_us) out->worst_press_us = latency;
+                out->presses++;
+            } else if (event.type == INPUT_RELEASE) {
+                uint32_t latency = (uint32_t)(t - release_edge);
+                if (latency > out->worst_release_us) out->worst_release_us = latency;
+                out->releases++;
+            } else {
+                out->repeats++;
+            }
+        }
+    }
+    return input_state() == 0;
+}
+
+// Latest a change may be reported: the line settles at the last edge of
+// its bounce, then needs SETTLE_SAMPLES scans, the first up to one scan
+// later
+static uint32_t latency_limit(const trace_t *trace, bool press) {
+    uint32_t first = 0;
+    uint32_t last = 0;
+    for (uint8_t i = 0; i < trace->edge_count; i++) {
+        if (i > 0 && trace->edges[i] - trace->edges[i - 1] > SETTLE_SAMPLES * INPUT_SCAN_US) {
+            if (press) break;
+            first = trace->edges[i];
+        }
+        last = trace->edges[i];
+    }
+    if (press) first = 0;
+    return last - first + SETTLE_SAMPLES * INPUT_SCAN_US;
+}
+
+int main(void) {
+    input_init(1u << BUTTON);
+    if (!scan) return 1;
+
+    printf("%-14s %5s %6s %6s %7s %12s %12s\n",
+           "trace", "phase", "press", "release", "repeat", "press lat", "release lat");
+
+    bool ok = true;
+    for (uint32_t i = 0; i < sizeof(traces) / sizeof(traces[0]); i++) {
+        const trace_t *trace = &traces[i];
+        uint32_t press_limit = latency_limit(trace, true);
+        uint32_t release_limit = latency_limit(trace, false);
+
+        for (uint32_t p = 0; p < sizeof(phases) / sizeof(phases[0]); p++) {
+            replay_result_t r;
+            bool good = replay(trace, phases[p], &r);
+            good &= r.presses == trace->presses && r.releases == trace->releases;
+            good &= r.repeats >= trace->min_repeats && r.repeats <= trace->max_repeats;
+            good &= r.worst_press_us <= press_limit && r.worst_release_us <= release_limit;
+
+            printf("%-14s %5u %6u %6u %7u %9u us %9u us  %s\n", trace->name, phases[p],
+                   r.presses, r.releases, r.repeats, r.worst_press_us, r.worst_release_us,
+                   good ? "ok" : "FAIL");
+            ok &= good;
+        }
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,118 @@
+/**
+ * Lil Guy - Panel Stub
+ * Just enough hardware for host tests that draw through display.c and
+ * tft_spi.c: SPI bytes and DMA runs go straight to the emulated ST7796
+ * (st7796.c) and finish at once, and time only moves on sleeps. Tests
+ * read the result back with st7796_screen().
+ */
+
+#include "pico/stdlib.h"
+#include "hardware/gpio.h"
+#include "hardware/spi.h"
+#include "hardware/dma.h"
+#include "tft_bus.h"
+#include "st7796.h"
+
+struct spi_inst {
+    spi_hw_t hw;
+    uint data_bits;
+};
+
+static struct spi_inst spi0_inst = {.data_bits = 8};
+spi_inst_t *const spi0 = &spi0_inst;
+
+static uint64_t now_us;
+static bool cs_low;
+static bool dc_high;
+
+// Bytes only reach the panel while it is selected
+static void panel_send(uint8_t byte) {
+    if (cs_low) st7796_write(byte, dc_high);
+}
+
+uint64_t time_us_64(void) {
+    return now_us;
+}
+
+void sleep_ms(uint32_t ms) {
+    now_us += (uint64_t)ms * 1000;
+}
+
+uint get_core_num(void) {
+    return 0;
+}
+
+void tft_vsync_init(void) {}
+
+void gpio_init(uint gpio) {}
+void gpio_set_dir(uint gpio, bool out) {}
+void gpio_set_function(uint gpio, uint fn) {}
+
+void gpio_put(uint gpio, bool value) {
+    if (gpio == TFT_CS) cs_low = !value;
+    if (gpio == TFT_DC) dc_high = value;
+}
+
+uint spi_init(spi_inst_t *spi, uint baudrate) {
+    return baudrate;
+}
+
+void spi_set_format(spi_inst_t *spi, uint data_bits, spi_cpol_t cpol, spi_cpha_t cpha, spi_order_t order) {
+    spi->data_bits = data_bits;
+}
+
+int spi_write_blocking(spi_inst_t *spi, const uint8_t *src, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        panel_send(src[i]);
+    }
+    return (int)len;
+}
+
+bool spi_is_busy(const spi_inst_t *spi) {
+    return false;
+}
+
+spi_hw_t *spi_get_hw(spi_inst_t *spi) {
+    return &spi->hw;
+}
+
+uint spi_get_dreq(spi_inst_t *spi, bool is_tx) {
+    return 24;
+}
+
+// One channel, 16-bit runs to the display SPI
+int dma_claim_unused_channel(bool required) {
+    return 0;
+}
+
+dma_channel_config dma_channel_get_default_config(uint channel) {
+    return (dma_channel_config){.size = DMA_SIZE_32, .read_increment = true, .chain_to = (int)channel};
+}
+
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size) {
+    c->size = size;
+}
+
+void channel_config_set_read_increment(dma_channel_config *c, bool incr) {
+    c->read_increment = incr;
+}
+
+void channel_config_set_write_increment(dma_channel_config *c, bool incr) {}
+void channel_config_set_dreq(dma_channel_config *c, uint dreq) {}
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint32_t transfer_count, bool trigger) {
+    const volatile uint16_t *src = read_addr;
+    for (uint32_t i = 0; i < transfer_count; i++) {
+        uint16_t v = *src;
+        if (spi0_inst.data_bits > 8) panel_send(v >> 8);
+        panel_send(v & 0xFF);
+        if (config->read_increment) src++;
+    }
+}
+
+bool dma_channel_is_busy(uint channel) {
+    return false;
+}
+
+void dma_channel_wait_for_finish_blocking(uint channel) {}
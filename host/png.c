@@ -0,0 +1,130 @@
+#include "png.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// Deflate "stored" blocks carry at most this many bytes
+#define STORED_MAX      65535
+
+static uint32_t crc_table[256];
+
+static void crc_init(void) {
+    if (crc_table[1]) return;
+
+    for (uint32_t n = 0; n < 256; n++) {
+        uint32_t c = n;
+        for (uint8_t k = 0; k < 8; k++) {
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        crc_table[n] = c;
+    }
+}
+
+static uint32_t crc_update(uint32_t crc, const uint8_t *buf, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        crc = crc_table[(crc ^ buf[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+static void put_be32(uint8_t *p, uint32_t v) {
+    p[0] = v >> 24;
+    p[1] = v >> 16;
+    p[2] = v >> 8;
+    p[3] = v;
+}
+
+static void write_chunk(FILE *f, const char *type, const uint8_t *data, uint32_t len) {
+    uint8_t header[8];
+    put_be32(header, len);
+    header[4] = type[0];
+    header[5] = type[1];
+    header[6] = type[2];
+    header[7] = type[3];
+    fwrite(header, 1, 8, f);
+    if (len) fwrite(data, 1, len, f);
+
+    uint32_t crc = crc_update(0xFFFFFFFFu, header + 4, 4);
+    crc = crc_update(crc, data, len) ^ 0xFFFFFFFFu;
+    uint8_t trailer[4];
+    put_be32(trailer, crc);
+    fwrite(trailer, 1, 4, f);
+}
+
+bool png_write_rgb565(const char *path, const uint16_t *pixels, uint16_t width, uint16_t height) {
+    crc_init();
+
+    // Filter byte (none) plus RGB for every row
+    size_t stride = 1 + (size_t)width * 3;
+    size_t raw_len = stride * height;
+    uint8_t *raw = malloc(raw_len);
+    if (!raw) return false;
+
+    for (uint16_t y = 0; y < height; y++) {
+        uint8_t *row = raw + y * stride;
+        *row++ = 0;
+        for (uint16_t x = 0; x < width; x++) {
+            uint16_t c = pixels[y * width + x];
+            uint8_t r = (c >> 11) & 0x1F;
+            uint8_t g = (c >> 5) & 0x3F;
+            uint8_t b = c & 0x1F;
+            *row++ = (r << 3) | (r >> 2);
+            *row++ = (g << 2) | (g >> 4);
+            *row++ = (b << 3) | (b >> 2);
+        }
+    }
+
+    // zlib stream of stored blocks: header, blocks, Adler-32
+    size_t blocks = (raw_len + STORED_MAX - 1) / STORED_MAX;
+    size_t z_len = 2 + blocks * 5 + raw_len + 4;
+    uint8_t *z = malloc(z_len);
+    if (!z) {
+        free(raw);
+        return false;
+    }
+
+    uint8_t *p = z;
+    *p++ = 0x78;
+    *p++ = 0x01;
+
+    uint32_t a = 1, b = 0;
+    for (size_t off = 0; off < raw_len; off += STORED_MAX) {
+        size_t n = raw_len - off < STORED_MAX ? raw_len - off : STORED_MAX;
+        *p++ = off + n == raw_len ? 1 : 0;
+        *p++ = n & 0xFF;
+        *p++ = n >> 8;
+        *p++ = ~n & 0xFF;
+        *p++ = (~n >> 8) & 0xFF;
+        for (size_t i = 0; i < n; i++) {
+            uint8_t v = raw[off + i];
+            *p++ = v;
+            a = (a + v) % 65521;
+            b = (b + a) % 65521;
+        }
+    }
+    put_be32(p, (b << 16) | a);
+
+    bool ok = false;
+    FILE *f = fopen(path, "wb");
+    if (f) {
+        static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+        fwrite(signature, 1, 8, f);
+
+        uint8_t ihdr[13];
+        put_be32(ihdr, width);
+        put_be32(ihdr + 4, height);
+        ihdr[8] = 8;    // Bit depth
+        ihdr[9] = 2;    // Truecolor
+        ihdr[10] = 0;   // Deflate
+        ihdr[11] = 0;   // Adaptive filtering
+        ihdr[12] = 0;   // No interlace
+        write_chunk(f, "IHDR", ihdr, sizeof(ihdr));
+        write_chunk(f, "IDAT", z, (uint32_t)z_len);
+        write_chunk(f, "IEND", NULL, 0);
+
+        ok = fclose(f) == 0;
+    }
+
+    free(z);
+    free(raw);
+    return ok;
+}
@@ -0,0 +1,10 @@
+#ifndef PNG_H
+#define PNG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Write an RGB565 image as an 8-bit RGB PNG (uncompressed deflate)
+bool png_write_rgb565(const char *path, const uint16_t *pixels, uint16_t width, uint16_t height);
+
+#endif // PNG_H
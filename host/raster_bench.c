@@ -0,0 +1,241 @@
+/**
+ * Lil Guy - Rasterizer Benchmark
+ * Times raster.c's span fills against per-pixel drawing of the same
+ * shapes and checks both produce identical pixels. The circle reference
+ * is the midpoint fill that display.c used before raster.c; the others
+ * walk the same edges but plot one bounds-checked pixel at a time, as
+ * that code did.
+ *
+ * Usage: lil_guy_raster_bench [shapes]
+ * Exits non-zero if any shape differs.
+ */
+
+#include "display.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SPRITE_W        220
+#define SPRITE_H        220
+
+static uint16_t new_pixels[SPRITE_W * SPRITE_H];
+static uint16_t old_pixels[SPRITE_W * SPRITE_H];
+static sprite_t new_sprite = {new_pixels, SPRITE_W, SPRITE_H, NULL};
+static sprite_t old_sprite = {old_pixels, SPRITE_W, SPRITE_H, NULL};
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+// ===== PER-PIXEL REFERENCES =====
+
+static void set_pixel(sprite_t *s, int16_t x, int16_t y, uint16_t color) {
+    if (x >= 0 && x < s->width && y >= 0 && y < s->height) {
+        s->buffer[y * s->width + x] = color;
+    }
+}
+
+static void old_hline(sprite_t *s, int16_t x0, int16_t x1, int16_t y, uint16_t color) {
+    if (x0 > x1) { int16_t t = x0; x0 = x1; x1 = t; }
+    for (int16_t x = x0; x <= x1; x++) set_pixel(s, x, y, color);
+}
+
+// Midpoint fill, as display.c had it; cl..cr and ct..cb are the centres
+// of the left/right and top/bottom halves (equal for a plain circle)
+static void old_fill_circle_halves(sprite_t *s, int16_t cl, int16_t cr, int16_t ct, int16_t cb,
+                                   int16_t r, uint16_t color) {
+    int16_t f = 1 - r;
+    int16_t ddF_x = 1;
+    int16_t ddF_y = -2 * r;
+    int16_t x = 0;
+    int16_t y = r;
+
+    for (int16_t row = ct; row <= cb; row++) old_hline(s, cl - r, cr + r, row, color);
+
+    while (x < y) {
+        if (f >= 0) {
+            y--;
+            ddF_y += 2;
+            f += ddF_y;
+        }
+        x++;
+        ddF_x += 2;
+        f += ddF_x;
+
+        old_hline(s, cl - x, cr + x, cb + y, color);
+        old_hline(s, cl - x, cr + x, ct - y, color);
+        old_hline(s, cl - y, cr + y, cb + x, color);
+        old_hline(s, cl - y, cr + y, ct - x, color);
+    }
+}
+
+static void old_fill_circle(sprite_t *s, int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+    old_fill_circle_halves(s, x0, x0, y0, y0, r, color);
+}
+
+static void old_fill_round_rect(sprite_t *s, int16_t x, int16_t y, int16_t w, int16_t h,
+                                int16_t r, uint16_t color) {
+    if (w <= 0 || h <= 0) return;
+    if (r > w / 2) r = w / 2;
+    if (r > h / 2) r = h / 2;
+    old_fill_circle_halves(s, x + r, x + w - 1 - r, y + r, y + h - 1 - r, r, color);
+}
+
+static void old_fill_triangle(sprite_t *s, int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                              int16_t x2, int16_t y2, uint16_t color) {
+    int16_t t;
+    if (y0 > y1) { t = y0; y0 = y1; y1 = t; t = x0; x0 = x1; x1 = t; }
+    if (y1 > y2) { t = y1; y1 = y2; y2 = t; t = x1; x1 = x2; x2 = t; }
+    if (y0 > y1) { t = y0; y0 = y1; y1 = t; t = x0; x0 = x1; x1 = t; }
+
+    if (y0 == y2) {
+        int16_t a = x0, b = x0;
+        if (x1 < a) a = x1; else if (x1 > b) b = x1;
+        if (x2 < a) a = x2; else if (x2 > b) b = x2;
+        old_hline(s, a, b, y0, color);
+        return;
+    }
+
+    int32_t step_a = ((int32_t)(x2 - x0) << 16) / (y2 - y0);
+    int32_t xa = (int32_t)x0 << 16;
+    int32_t step_b = y1 > y0 ? ((int32_t)(x1 - x0) << 16) / (y1 - y0) : 0;
+    int32_t xb = (int32_t)x0 << 16;
+    for (int16_t y = y0; y <= y2; y++) {
+        if (y == y1) {
+            step_b = y2 > y1 ? ((int32_t)(x2 - x1) << 16) / (y2 - y1) : 0;
+            xb = (int32_t)x1 << 16;
+        }
+        old_hline(s, (xa + 0x8000) >> 16, (xb + 0x8000) >> 16, y, color);
+        xa += step_a;
+        xb += step_b;
+    }
+}
+
+// Textbook Bresenham, one pixel per step
+static void old_draw_line(sprite_t *s, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+    bool steep = abs(y1 - y0) > abs(x1 - x0);
+    int16_t t;
+    if (steep) { t = x0; x0 = y0; y0 = t; t = x1; x1 = y1; y1 = t; }
+    if (x0 > x1) { t = x0; x0 = x1; x1 = t; t = y0; y0 = y1; y1 = t; }
+
+    int16_t dx = x1 - x0;
+    int16_t dy = abs(y1 - y0);
+    int16_t err = dx / 2;
+    int16_t ystep = y0 < y1 ? 1 : -1;
+    for (; x0 <= x1; x0++) {
+        if (steep) set_pixel(s, y0, x0, color);
+        else set_pixel(s, x0, y0, color);
+        err -= dy;
+        if (err < 0) {
+            y0 += ystep;
+            err += dx;
+        }
+    }
+}
+
+// ===== SHAPES =====
+
+typedef enum {
+    SHAPE_CIRCLE,
+    SHAPE_ROUND_RECT,
+    SHAPE_TRIANGLE,
+    SHAPE_LINE,
+    SHAPE_KINDS
+} shape_kind_t;
+
+static const char *shape_names[SHAPE_KINDS] = {"circle", "round rect", "triangle", "line"};
+
+// Random shape, partly off the sprite now and then to exercise clipping
+typedef struct {
+    int16_t a[6];
+} shape_t;
+
+static int16_t coord(int16_t size) {
+    return rand() % (size + 40) - 20;
+}
+
+static void make_shape(shape_kind_t kind, shape_t *s) {
+    for (int i = 0; i < 6; i += 2) {
+        s->a[i] = coord(SPRITE_W);
+        s->a[i + 1] = coord(SPRITE_H);
+    }
+    if (kind == SHAPE_CIRCLE) s->a[2] = rand() % 100;
+    if (kind == SHAPE_ROUND_RECT) {
+        s->a[2] = rand() % 160 + 1;
+        s->a[3] = rand() % 160 + 1;
+        s->a[4] = rand() % 40;
+    }
+}
+
+static void draw_new(shape_kind_t kind, const shape_t *s, uint16_t c) {
+    const int16_t *a = s->a;
+    switch (kind) {
+        case SHAPE_CIRCLE:     sprite_fill_circle(&new_sprite, a[0], a[1], a[2], c); break;
+        case SHAPE_ROUND_RECT: sprite_fill_round_rect(&new_sprite, a[0], a[1], a[2], a[3], a[4], c); break;
+        case SHAPE_TRIANGLE:   sprite_fill_triangle(&new_sprite, a[0], a[1], a[2], a[3], a[4], a[5], c); break;
+        default:               sprite_draw_line(&new_sprite, a[0], a[1], a[2], a[3], c); break;
+    }
+}
+
+static void draw_old(shape_kind_t kind, const shape_t *s, uint16_t c) {
+    const int16_t *a = s->a;
+    switch (kind) {
+        case SHAPE_CIRCLE:     old_fill_circle(&old_sprite, a[0], a[1], a[2], c); break;
+        case SHAPE_ROUND_RECT: old_fill_round_rect(&old_sprite, a[0], a[1], a[2], a[3], a[4], c); break;
+        case SHAPE_TRIANGLE:   old_fill_triangle(&old_sprite, a[0], a[1], a[2], a[3], a[4], a[5], c); break;
+        default:               old_draw_line(&old_sprite, a[0], a[1], a[2], a[3], c); break;
+    }
+}
+
+// Pixels each shape covers, to turn times into pixel rates
+static uint64_t covered(void) {
+    uint64_t n = 0;
+    for (uint32_t i = 0; i < SPRITE_W * SPRITE_H; i++) n += old_pixels[i] != 0;
+    return n;
+}
+
+int main(int argc, char **argv) {
+    uint32_t count = argc > 1 ? (uint32_t)atoi(argv[1]) : 20000;
+    if (count == 0) count = 1;
+
+    shape_t *shapes = malloc(count * sizeof(shape_t));
+    if (!shapes) return 1;
+
+    printf("%-12s %12s %12s %8s %10s\n", "shape", "span Mpx/s", "pixel Mpx/s", "speedup", "mismatch");
+
+    bool ok = true;
+    for (shape_kind_t kind = 0; kind < SHAPE_KINDS; kind++) {
+        srand(kind + 1);
+        for (uint32_t i = 0; i < count; i++) make_shape(kind, &shapes[i]);
+
+        // Same pixels, one shape at a time on a cleared sprite
+        uint32_t mismatched = 0;
+        uint64_t pixels = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            memset(new_pixels, 0, sizeof(new_pixels));
+            memset(old_pixels, 0, sizeof(old_pixels));
+            draw_new(kind, &shapes[i], 0xFFFF);
+            draw_old(kind, &shapes[i], 0xFFFF);
+            mismatched += memcmp(new_pixels, old_pixels, sizeof(new_pixels)) != 0;
+            pixels += covered();
+        }
+
+        uint64_t t0 = now_ns();
+        for (uint32_t i = 0; i < count; i++) draw_new(kind, &shapes[i], i);
+        uint64_t t1 = now_ns();
+        for (uint32_t i = 0; i < count; i++) draw_old(kind, &shapes[i], i);
+        uint64_t t2 = now_ns();
+
+        double span_rate = pixels * 1000.0 / (t1 - t0);
+        double pixel_rate = pixels * 1000.0 / (t2 - t1);
+        printf("%-12s %12.1f %12.1f %7.1fx %10u\n", shape_names[kind],
+               span_rate, pixel_rate, span_rate / pixel_rate, mismatched);
+        if (mismatched) ok = false;
+    }
+
+    free(shapes);
+    return ok ? 0 : 1;
+}
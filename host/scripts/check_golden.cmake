@@ -0,0 +1,88 @@
+# Run lil_guy_sim on a script and compare its output with a golden file:
+# the MD5 of every PNG the script snaps, and the SPI bytes of every frame
+# in frames.csv. Any rendering or transfer change shows up as a failure
+# naming what moved.
+#
+#   cmake -DSIM=<lil_guy_sim> -DSCRIPT=<script> -DGOLDEN=<file> -DOUT=<dir>
+#         [-DUPDATE=ON] -P check_golden.cmake
+#
+# UPDATE=ON rewrites the golden file from this run instead of checking.
+
+foreach (var SIM SCRIPT GOLDEN OUT)
+    if (NOT DEFINED ${var})
+        message(FATAL_ERROR "check_golden.cmake needs -D${var}=...")
+    endif()
+endforeach()
+
+file(REMOVE_RECURSE ${OUT})
+file(MAKE_DIRECTORY ${OUT})
+execute_process(
+    COMMAND ${SIM} -o ${OUT} ${SCRIPT}
+    OUTPUT_FILE ${OUT}/sim.log
+    ERROR_FILE ${OUT}/sim.log
+    RESULT_VARIABLE result
+    )
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "lil_guy_sim exited with ${result}, see ${OUT}/sim.log")
+endif()
+
+# This run, in the golden file's format
+set(actual "")
+file(GLOB pngs RELATIVE ${OUT} ${OUT}/*.png)
+list(SORT pngs)
+foreach (png ${pngs})
+    file(MD5 ${OUT}/${png} hash)
+    string(APPEND actual "png ${png} ${hash}\n")
+endforeach()
+
+file(STRINGS ${OUT}/frames.csv rows)
+list(REMOVE_AT rows 0)
+foreach (row ${rows})
+    string(REPLACE "," ";" fields "${row}")
+    list(GET fields 0 frame)
+    list(GET fields 2 spi_bytes)
+    string(APPEND actual "spi ${frame} ${spi_bytes}\n")
+endforeach()
+
+if (UPDATE)
+    get_filename_component(script_name ${SCRIPT} NAME)
+    file(WRITE ${GOLDEN}
+        "# lil_guy_sim output for ${script_name}, checked by the sim_golden test.\n"
+        "# Regenerate after an intended change with check_golden.cmake -DUPDATE=ON.\n"
+        "${actual}")
+    message(STATUS "Wrote ${GOLDEN}")
+    return()
+endif()
+
+file(STRINGS ${GOLDEN} expected REGEX "^[a-z]")
+string(REGEX REPLACE "\n$" "" actual "${actual}")
+string(REPLACE "\n" ";" actual "${actual}")
+
+# Report every difference, not just the first
+set(failures 0)
+foreach (line ${expected})
+    list(FIND actual "${line}" found)
+    if (found EQUAL -1)
+        string(REGEX MATCH "^[a-z]+ [^ ]+" key "${line}")
+        set(got "missing")
+        foreach (a ${actual})
+            if (a MATCHES "^${key} ")
+                set(got "${a}")
+            endif()
+        endforeach()
+        message(SEND_ERROR "Expected '${line}', got '${got}'")
+        math(EXPR failures "${failures} + 1")
+    endif()
+endforeach()
+
+list(LENGTH expected expected_count)
+list(LENGTH actual actual_count)
+if (NOT expected_count EQUAL actual_count)
+    message(SEND_ERROR "Expected ${expected_count} entries, got ${actual_count}")
+    math(EXPR failures "${failures} + 1")
+endif()
+
+if (failures)
+    message(FATAL_ERROR "${failures} differences from ${GOLDEN}; output in ${OUT}")
+endif()
+message(STATUS "Matches ${GOLDEN}")
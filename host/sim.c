@@ -0,0 +1,292 @@
+/**
+ * Lil Guy - Host Simulator
+ * Runs the unmodified firmware against the SDK shim in hal.c, with an
+ * ST7796 panel, a GT911 touch controller and scripted buttons/joystick.
+ *
+ * Usage: lil_guy_sim [-o dir] [-n frames] [-t ms] [-T file] [script]
+ *   -o  Output directory for frames.csv and PNGs (default .)
+ *   -n  Also dump the panel every n frames
+ *   -t  Stop after this much virtual time if the script has no "end"
+ *   -T  Write raw USB output (trace packets) to this file
+ *
+ * Script lines are "<ms> <command> [args]", ms counted from boot:
+ *   press <gpio> / release <gpio>
+ *   adc <x> <y>              Raw 12-bit readings for ADC0/ADC1
+ *   touch <id> <x> <y>       Contact down or moved
+ *   lift <id>
+ *   snap <file.png>
+ *   end
+ */
+
+#include "sdk_shim.h"
+#include "sim.h"
+#include "st7796.h"
+#include "gt911.h"
+#include "png.h"
+#include "render.h"
+#include "arena.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define DEFAULT_RUN_MS  10000
+
+typedef enum {
+    EV_PRESS,
+    EV_RELEASE,
+    EV_ADC,
+    EV_TOUCH,
+    EV_LIFT,
+    EV_SNAP,
+    EV_END
+} sim_event_type_t;
+
+typedef struct {
+    uint64_t time_us;
+    uint8_t type;             // sim_event_type_t
+    uint16_t args[3];
+    char name[64];
+} sim_event_t;
+
+static sim_event_t *events;
+static uint32_t event_count;
+static uint32_t next_event;
+
+static const char *out_dir = ".";
+static uint32_t snap_every;
+static FILE *frames_csv;
+
+// Per-frame accounting
+static uint32_t frame_count;
+static uint64_t last_bytes;
+static uint64_t last_pixels;
+static uint64_t max_frame_bytes;
+
+// Firmware entry point (main.c, renamed for the host build)
+int lil_guy_main(void);
+
+// ===== SCRIPT =====
+
+static bool add_event(const sim_event_t *event) {
+    static uint32_t capacity;
+
+    if (event_count && event->time_us < events[event_count - 1].time_us) {
+        fprintf(stderr, "sim: script times must not go backwards\n");
+        return false;
+    }
+    if (event_count == capacity) {
+        capacity = capacity ? capacity * 2 : 64;
+        events = realloc(events, capacity * sizeof(sim_event_t));
+        if (!events) return false;
+    }
+    events[event_count++] = *event;
+    return true;
+}
+
+static bool load_script(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+
+    char line[256];
+    uint32_t line_no = 0;
+    while (fgets(line, sizeof(line), f)) {
+        line_no++;
+        char *hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+
+        unsigned long ms;
+        char cmd[16];
+        char arg[64] = "";
+        unsigned a = 0, b = 0, c = 0;
+        int n = sscanf(line, "%lu %15s", &ms, cmd);
+        if (n <= 0) continue;
+        if (n != 2) goto bad;
+
+        sim_event_t event = {.time_us = (uint64_t)ms * 1000};
+        const char *rest = strstr(line, cmd) + strlen(cmd);
+
+        if (!strcmp(cmd, "press") || !strcmp(cmd, "release")) {
+            if (sscanf(rest, "%u", &a) != 1 || a > 29) goto bad;
+            event.type = cmd[0] == 'p' ? EV_PRESS : EV_RELEASE;
+        } else if (!strcmp(cmd, "adc")) {
+            if (sscanf(rest, "%u %u", &a, &b) != 2 || a > 4095 || b > 4095) goto bad;
+            event.type = EV_ADC;
+        } else if (!strcmp(cmd, "touch")) {
+            if (sscanf(rest, "%u %u %u", &a, &b, &c) != 3) goto bad;
+            event.type = EV_TOUCH;
+        } else if (!strcmp(cmd, "lift")) {
+            if (sscanf(rest, "%u", &a) != 1) goto bad;
+            event.type = EV_LIFT;
+        } else if (!strcmp(cmd, "snap")) {
+            if (sscanf(rest, "%63s", arg) != 1) goto bad;
+            event.type = EV_SNAP;
+        } else if (!strcmp(cmd, "end")) {
+            event.type = EV_END;
+        } else {
+            goto bad;
+        }
+
+        event.args[0] = a;
+        event.args[1] = b;
+        event.args[2] = c;
+        strcpy(event.name, arg);
+        if (!add_event(&event)) {
+            fclose(f);
+            return false;
+        }
+        continue;
+
+    bad:
+        fprintf(stderr, "%s:%u: bad script line\n", path, line_no);
+        fclose(f);
+        return false;
+    }
+
+    fclose(f);
+    return true;
+}
+
+static void snapshot(const char *name) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", out_dir, name);
+    if (!png_write_rgb565(path, st7796_screen(), ST7796_WIDTH, ST7796_HEIGHT)) {
+        fprintf(stderr, "sim: failed to write %s\n", path);
+    }
+}
+
+static void finish(void) {
+    const st7796_stats_t *panel = st7796_stats();
+    const volatile render_stats_t *render = render_stats();
+
+    printf("\n=== Simulation finished at %.3f s ===\n", time_us_64() / 1e6);
+    printf("Frames:           %u (%u drawn by core1)\n", frame_count, render->frames_drawn);
+    printf("SPI bytes:        %llu total, %llu/frame avg, %llu/frame max\n",
+           (unsigned long long)panel->bytes,
+           (unsigned long long)(frame_count ? panel->bytes / frame_count : 0),
+           (unsigned long long)max_frame_bytes);
+    printf("Pixels written:   %llu\n", (unsigned long long)panel->pixels);
+
+    // Peak is what ARENA_STATIC_SIZE has to cover
+    const arena_stats_t *mem = arena_stats(&arena_static);
+    printf("Static arena:     %lu of %lu bytes at peak, %lu failed allocations\n",
+           (unsigned long)mem->high_water, (unsigned long)mem->size, (unsigned long)mem->failed);
+
+    if (frames_csv) fclose(frames_csv);
+    exit(0);
+}
+
+uint64_t sim_next_event_us(void) {
+    return next_event < event_count ? events[next_event].time_us : UINT64_MAX;
+}
+
+void sim_run_event(void) {
+    const sim_event_t *event = &events[next_event++];
+
+    switch (event->type) {
+        case EV_PRESS:
+            hal_set_input(event->args[0], false);
+            break;
+        case EV_RELEASE:
+            hal_set_input(event->args[0], true);
+            break;
+        case EV_ADC:
+            hal_set_adc(event->args[0], event->args[1]);
+            break;
+        case EV_TOUCH:
+            gt911_touch(event->args[0], event->args[1], event->args[2]);
+            break;
+        case EV_LIFT:
+            gt911_lift(event->args[0]);
+            break;
+        case EV_SNAP:
+            snapshot(event->name);
+            break;
+        case EV_END:
+            finish();
+            break;
+    }
+}
+
+void sim_frame_end(void) {
+    const st7796_stats_t *panel = st7796_stats();
+    uint64_t bytes = panel->bytes - last_bytes;
+    uint64_t pixels = panel->pixels - last_pixels;
+    last_bytes = panel->bytes;
+    last_pixels = panel->pixels;
+    if (bytes > max_frame_bytes) max_frame_bytes = bytes;
+
+    // Time the bus would need for this frame at the configured clock
+    uint32_t baud = hal_spi_baud();
+    uint64_t bus_us = baud ? bytes * 8 * 1000000 / baud : 0;
+
+    if (frames_csv) {
+        fprintf(frames_csv, "%u,%llu,%llu,%llu,%llu\n", frame_count,
+                (unsigned long long)time_us_64(), (unsigned long long)bytes,
+                (unsigned long long)pixels, (unsigned long long)bus_us);
+    }
+
+    if (snap_every && frame_count % snap_every == 0) {
+        char name[32];
+        snprintf(name, sizeof(name), "frame_%05u.png", frame_count);
+        snapshot(name);
+    }
+    frame_count++;
+}
+
+// ===== MAIN =====
+
+int main(int argc, char **argv) {
+    uint32_t run_ms = DEFAULT_RUN_MS;
+
+    const char *usb_path = NULL;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "o:n:t:T:")) != -1) {
+        switch (opt) {
+            case 'o': out_dir = optarg; break;
+            case 'n': snap_every = strtoul(optarg, NULL, 0); break;
+            case 't': run_ms = strtoul(optarg, NULL, 0); break;
+            case 'T': usb_path = optarg; break;
+            default:
+                fprintf(stderr, "usage: %s [-o dir] [-n frames] [-t ms] [-T file] [script]\n", argv[0]);
+                return 2;
+        }
+    }
+
+    if (optind < argc && !load_script(argv[optind])) {
+        return 1;
+    }
+
+    // Without an explicit end, stop after the run time (or the last event)
+    if (!event_count || events[event_count - 1].type != EV_END) {
+        sim_event_t end = {.time_us = (uint64_t)run_ms * 1000, .type = EV_END};
+        if (event_count && events[event_count - 1].time_us > end.time_us) {
+            end.time_us = events[event_count - 1].time_us;
+        }
+        add_event(&end);
+    }
+
+    char path[512];
+    snprintf(path, sizeof(path), "%s/frames.csv", out_dir);
+    frames_csv = fopen(path, "w");
+    if (!frames_csv) {
+        perror(path);
+        return 1;
+    }
+    fprintf(frames_csv, "frame,time_us,spi_bytes,pixels,bus_us\n");
+
+    if (usb_path) {
+        FILE *usb = fopen(usb_path, "wb");
+        if (!usb) {
+            perror(usb_path);
+            return 1;
+        }
+        hal_set_usb_capture(usb);
+    }
+
+    return lil_guy_main();
+}
@@ -0,0 +1,37 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+// ===== SCRIPT (sim.c) =====
+
+// Time of the next scripted event, UINT64_MAX when there are none
+uint64_t sim_next_event_us(void);
+
+// Apply the next scripted event; the clock is already at its time
+void sim_run_event(void);
+
+// Core0 finished a frame and is about to sleep until the next one; core1
+// has drained its queue, so the panel holds everything posted so far
+void sim_frame_end(void);
+
+// ===== HAL HOOKS (hal.c) =====
+
+// Level on an input pin (inputs idle high, as if pulled up)
+void hal_set_input(unsigned gpio, bool level);
+
+// Values the ADC ring DMA will see for inputs 0 and 1
+void hal_set_adc(uint16_t adc0, uint16_t adc1);
+
+// Raise GPIO interrupt events on a pin, if enabled
+void hal_gpio_irq(unsigned gpio, uint32_t events);
+
+// SPI clock set by spi_init, for bus time estimates
+uint32_t hal_spi_baud(void);
+
+// Where putchar_raw output goes, NULL to drop it
+void hal_set_usb_capture(FILE *f);
+
+#endif // SIM_H
@@ -0,0 +1,170 @@
+/**
+ * Lil Guy - Indexed Sprite Test
+ * Encodes generated RGB565 images into all five indexed formats, the way
+ * display.h documents them, and checks that indexed_sprite_push() onto
+ * the emulated panel and indexed_sprite_draw() at clipped positions both
+ * give back the source pixels. Sizes are picked to stress the decoder:
+ * odd widths that leave sub-byte padding at the end of each row, rows
+ * wider than one expansion chunk, and RLE runs that cross rows, chunks
+ * and the 128-pixel run limit.
+ *
+ * Usage: lil_guy_sprite_fmt_test
+ * Exits non-zero if any decode differs from its source.
+ */
+
+#include "display.h"
+#include "st7796.h"
+#include "tft_bus.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+_Static_assert(TFT_ROTATION == TFT_ROTATE_0, "sprite_fmt_test expects the portrait build");
+
+#define MAX_W           300
+#define MAX_H           60
+#define DST_W           200
+#define DST_H           120
+
+static const char *format_names[] = {"index1", "index2", "index4", "index8", "rle8"};
+
+static uint8_t indices[MAX_W * MAX_H];
+static uint16_t source[MAX_W * MAX_H];
+static uint16_t palette[256];
+static uint8_t data[MAX_W * MAX_H * 2];
+
+static uint16_t dst_pixels[DST_W * DST_H];
+static uint16_t want_pixels[DST_W * DST_H];
+static sprite_t dst = {dst_pixels, DST_W, DST_H, NULL};
+
+// ===== ENCODERS =====
+
+static uint32_t pack(uint16_t w, uint16_t h, uint8_t bpp) {
+    uint32_t len = 0;
+    for (uint16_t y = 0; y < h; y++) {
+        uint8_t byte = 0;
+        uint8_t used = 0;
+        for (uint16_t x = 0; x < w; x++) {
+            byte = (byte << bpp) | indices[y * w + x];
+            used += bpp;
+            if (used == 8) {
+                data[len++] = byte;
+                byte = used = 0;
+            }
+        }
+        if (used) data[len++] = byte << (8 - used);
+    }
+    return len;
+}
+
+// Repeats of three or more, literals otherwise, both capped at 128
+static uint32_t rle8(uint32_t n) {
+    uint32_t len = 0;
+    uint32_t i = 0;
+    while (i < n) {
+        uint32_t run = 1;
+        while (i + run < n && run < 128 && indices[i + run] == indices[i]) run++;
+        if (run >= 3) {
+            data[len++] = 0x80 | (run - 1);
+            data[len++] = indices[i];
+            i += run;
+            continue;
+        }
+
+        uint32_t start = i;
+        while (i < n && i - start < 128 &&
+               !(i + 2 < n && indices[i] == indices[i + 1] && indices[i] == indices[i + 2])) {
+            i++;
+        }
+        data[len++] = i - start - 1;
+        memcpy(&data[len], &indices[start], i - start);
+        len += i - start;
+    }
+    return len;
+}
+
+// ===== IMAGES =====
+
+// Bands of flat color (long repeats, some crossing rows) and noise (long
+// literals), in as many colors as the format holds
+static void make_image(uint16_t w, uint16_t h, uint16_t colors) {
+    for (uint16_t c = 0; c < 256; c++) {
+        palette[c] = (uint16_t)(c * 40503u + 1);
+    }
+    for (uint32_t p = 0; p < (uint32_t)w * h; p++) {
+        uint16_t band = (p / 97) % 4;
+        indices[p] = band == 0 ? (p / 389) % colors : rand() % colors;
+        source[p] = palette[indices[p]];
+    }
+}
+
+static indexed_sprite_t encode(uint8_t format, uint16_t w, uint16_t h) {
+    make_image(w, h, format == SPRITE_RLE8 ? 255 : 1u << (1u << format));
+    if (format == SPRITE_RLE8) rle8((uint32_t)w * h);
+    else pack(w, h, 1u << format);
+    return (indexed_sprite_t){data, palette, w, h, format};
+}
+
+// ===== CHECKS =====
+
+static bool check_push(const indexed_sprite_t *s, uint16_t x, uint16_t y) {
+    indexed_sprite_push(s, x, y);
+    const uint16_t *screen = st7796_screen();
+    for (uint16_t row = 0; row < s->height; row++) {
+        if (memcmp(&screen[(y + row) * TFT_WIDTH + x], &source[row * s->width],
+                   s->width * sizeof(uint16_t)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool check_draw(const indexed_sprite_t *s, int16_t x, int16_t y) {
+    for (uint32_t p = 0; p < DST_W * DST_H; p++) {
+        dst_pixels[p] = want_pixels[p] = (uint16_t)p;
+    }
+    for (int16_t row = 0; row < s->height; row++) {
+        for (int16_t col = 0; col < s->width; col++) {
+            int16_t dx = x + col;
+            int16_t dy = y + row;
+            if (dx >= 0 && dy >= 0 && dx < DST_W && dy < DST_H) {
+                want_pixels[dy * DST_W + dx] = source[row * s->width + col];
+            }
+        }
+    }
+    indexed_sprite_draw(s, &dst, x, y);
+    return memcmp(dst_pixels, want_pixels, sizeof(dst_pixels)) == 0;
+}
+
+int main(void) {
+    tft_bus_init();
+
+    static const uint16_t sizes[][2] = {{1, 5}, {13, 1}, {37, 23}, {64, 16}, {259, 7}, {MAX_W, MAX_H}};
+    static const int16_t offsets[][2] = {{0, 0}, {5, 9}, {-7, -3}, {150, 100}, {-290, 50}, {-3, 115}};
+
+    bool ok = true;
+    for (uint8_t format = SPRITE_INDEX1; format <= SPRITE_RLE8; format++) {
+        uint32_t push_bad = 0;
+        uint32_t draw_bad = 0;
+        uint32_t checks = 0;
+
+        for (uint8_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+            srand(format * 16 + i);
+            indexed_sprite_t s = encode(format, sizes[i][0], sizes[i][1]);
+
+            push_bad += !check_push(&s, i * 3, i * 61);
+            for (uint8_t k = 0; k < sizeof(offsets) / sizeof(offsets[0]); k++) {
+                draw_bad += !check_draw(&s, offsets[k][0], offsets[k][1]);
+                checks++;
+            }
+        }
+
+        bool good = !push_bad && !draw_bad;
+        printf("%-7s push %u/%u bad, draw %u/%u bad  %s\n", format_names[format],
+               push_bad, (unsigned)(sizeof(sizes) / sizeof(sizes[0])), draw_bad, checks,
+               good ? "ok" : "FAIL");
+        ok &= good;
+    }
+
+    return ok ? 0 : 1;
+}
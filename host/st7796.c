@@ -0,0 +1,189 @@
+#include "st7796.h"
+#include <string.h>
+
+// Commands the firmware sends; everything else is accepted and ignored
+#define CMD_SWRESET     0x01
+#define CMD_CASET       0x2A
+#define CMD_RASET       0x2B
+#define CMD_RAMWR       0x2C
+#define CMD_VSCRDEF     0x33
+#define CMD_MADCTL      0x36
+#define CMD_VSCRSADD    0x37
+#define CMD_RAMWRC      0x3C
+
+#define MADCTL_MY       0x80
+#define MADCTL_MX       0x40
+#define MADCTL_MV       0x20
+
+static uint16_t framebuffer[ST7796_WIDTH * ST7796_HEIGHT];
+static uint16_t screen[ST7796_WIDTH * ST7796_HEIGHT];
+static st7796_stats_t stats;
+
+static uint8_t command;
+static uint8_t params[6];
+static uint8_t param_count;
+
+static uint8_t madctl;
+static uint16_t col_start, col_end = ST7796_WIDTH - 1;
+static uint16_t row_start, row_end = ST7796_HEIGHT - 1;
+static uint16_t col, row;
+
+// Vertical scrolling, in memory rows
+static uint16_t scroll_top, scroll_height = ST7796_HEIGHT;
+static uint16_t scroll_start;
+
+// RGB565 arrives MSB first, one byte at a time
+static uint8_t pixel_hi;
+static bool pixel_half;
+
+// ===== MEMORY WRITES =====
+
+static void store_pixel(uint16_t color) {
+    // Window coordinates are logical; MADCTL decides where they land
+    uint16_t x = col;
+    uint16_t y = row;
+    if (madctl & MADCTL_MV) {
+        uint16_t t = x;
+        x = y;
+        y = t;
+    }
+    if (madctl & MADCTL_MX) x = ST7796_WIDTH - 1 - x;
+    if (madctl & MADCTL_MY) y = ST7796_HEIGHT - 1 - y;
+
+    if (x < ST7796_WIDTH && y < ST7796_HEIGHT) {
+        framebuffer[y * ST7796_WIDTH + x] = color;
+        stats.pixels++;
+    }
+
+    // Advance along the row, wrapping to the next row of the window
+    if (col < col_end) {
+        col++;
+    } else {
+        col = col_start;
+        row = row < row_end ? row + 1 : row_start;
+    }
+}
+
+static void write_data(uint8_t byte) {
+    switch (command) {
+        case CMD_CASET:
+        case CMD_RASET:
+            if (param_count < 4) params[param_count++] = byte;
+            if (param_count == 4) {
+                uint16_t start = (params[0] << 8) | params[1];
+                uint16_t end = (params[2] << 8) | params[3];
+                if (command == CMD_CASET) {
+                    col_start = start;
+                    col_end = end;
+                } else {
+                    row_start = start;
+                    row_end = end;
+                }
+            }
+            break;
+
+        case CMD_RAMWR:
+        case CMD_RAMWRC:
+            if (!pixel_half) {
+                pixel_hi = byte;
+                pixel_half = true;
+            } else {
+                store_pixel((pixel_hi << 8) | byte);
+                pixel_half = false;
+            }
+            break;
+
+        case CMD_MADCTL:
+            madctl = byte;
+            break;
+
+        case CMD_VSCRDEF:
+            if (param_count < 6) params[param_count++] = byte;
+            if (param_count == 6) {
+                uint16_t top = (params[0] << 8) | params[1];
+                uint16_t height = (params[2] << 8) | params[3];
+                uint16_t bottom = (params[4] << 8) | params[5];
+
+                // The controller ignores areas that do not add up
+                if (top + height + bottom == ST7796_HEIGHT && height > 0) {
+                    scroll_top = top;
+                    scroll_height = height;
+                }
+            }
+            break;
+
+        case CMD_VSCRSADD:
+            if (param_count < 2) params[param_count++] = byte;
+            if (param_count == 2) {
+                scroll_start = (params[0] << 8) | params[1];
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+static void write_command(uint8_t cmd) {
+    command = cmd;
+    param_count = 0;
+    pixel_half = false;
+    stats.commands++;
+
+    switch (cmd) {
+        case CMD_SWRESET:
+            madctl = 0;
+            scroll_top = 0;
+            scroll_height = ST7796_HEIGHT;
+            scroll_start = 0;
+            col_start = 0;
+            col_end = ST7796_WIDTH - 1;
+            row_start = 0;
+            row_end = ST7796_HEIGHT - 1;
+            break;
+
+        case CMD_RAMWR:
+            col = col_start;
+            row = row_start;
+            break;
+
+        default:
+            break;
+    }
+}
+
+// ===== PUBLIC API =====
+
+void st7796_write(uint8_t byte, bool dc) {
+    stats.bytes++;
+    if (dc) {
+        write_data(byte);
+    } else {
+        write_command(byte);
+    }
+}
+
+const uint16_t* st7796_framebuffer(void) {
+    return framebuffer;
+}
+
+const uint16_t* st7796_screen(void) {
+    // Rows of the scroll area are shown from scroll_start, wrapping
+    uint16_t offset = 0;
+    if (scroll_start >= scroll_top && scroll_start < scroll_top + scroll_height) {
+        offset = scroll_start - scroll_top;
+    }
+    if (offset == 0) return framebuffer;
+
+    memcpy(screen, framebuffer, sizeof(screen));
+    for (uint16_t line = 0; line < scroll_height; line++) {
+        uint16_t src = scroll_top + (offset + line) % scroll_height;
+        memcpy(&screen[(scroll_top + line) * ST7796_WIDTH], &framebuffer[src * ST7796_WIDTH],
+               ST7796_WIDTH * sizeof(uint16_t));
+    }
+    return screen;
+}
+
+const st7796_stats_t* st7796_stats(void) {
+    return &stats;
+}
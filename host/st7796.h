@@ -0,0 +1,27 @@
+#ifndef ST7796_H
+#define ST7796_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Panel memory, portrait, as the controller stores it
+#define ST7796_WIDTH  320
+#define ST7796_HEIGHT 480
+
+typedef struct {
+    uint64_t bytes;           // Every byte clocked in, commands included
+    uint64_t pixels;          // Pixels written to panel memory
+    uint32_t commands;
+} st7796_stats_t;
+
+// One byte off the SPI bus; dc is the level of the D/C line
+void st7796_write(uint8_t byte, bool dc);
+
+// Panel memory
+const uint16_t* st7796_framebuffer(void);
+
+// What the panel shows: memory with vertical scrolling applied
+const uint16_t* st7796_screen(void);
+const st7796_stats_t* st7796_stats(void);
+
+#endif // ST7796_H
@@ -0,0 +1,118 @@
+/**
+ * Lil Guy - Tiled Renderer Test
+ * Renders a full-screen display list through tiles.c onto the emulated
+ * panel and checks it against the same scene rendered in one piece:
+ * pixel for pixel, and by tiles_stats() counts. A first frame sends
+ * every tile, an unchanged frame renders none, moving one circle sends
+ * only the tiles whose pixels changed, and an invalidated area is
+ * re-sent over whatever was drawn on top of it.
+ *
+ * Usage: lil_guy_tiles_test
+ * Exits non-zero on the first check that fails.
+ */
+
+#include "tiles.h"
+#include "st7796.h"
+#include "tft_bus.h"
+#include <stdio.h>
+#include <string.h>
+
+// The panel shows display coordinates only in the default orientation
+_Static_assert(TFT_ROTATION == TFT_ROTATE_0, "tiles_test expects the portrait build");
+
+static uint16_t ref_pixels[TFT_WIDTH * TFT_HEIGHT];
+static sprite_t ref = {ref_pixels, TFT_WIDTH, TFT_HEIGHT, NULL};
+
+static tile_renderer_t tr;
+static display_list_t scene;
+static bool ok = true;
+
+static void check(bool cond, const char *what) {
+    printf("  %-44s %s\n", what, cond ? "ok" : "FAIL");
+    if (!cond) ok = false;
+}
+
+static void record(int16_t ball_x, int16_t ball_y) {
+    display_list_clear(&scene);
+    display_list_fill(&scene, 0);
+    display_list_rect(&scene, 20, 30, 200, 90, 1);
+    display_list_round_rect(&scene, 40, 300, 240, 120, 24, 2);
+    display_list_triangle(&scene, 10, 470, 160, 200, 310, 460, 3);
+    display_list_line(&scene, 0, 0, 319, 479, 4);
+    display_list_circle(&scene, 250, 80, 60, 5);
+    display_list_circle(&scene, ball_x, ball_y, 30, 6);
+}
+
+static void render_reference(void) {
+    display_list_render(&scene, &ref, 0, 0);
+}
+
+static bool panel_matches(void) {
+    return memcmp(st7796_screen(), ref_pixels, sizeof(ref_pixels)) == 0;
+}
+
+// Tiles whose reference pixels differ between two renders
+static uint16_t changed_tiles(const uint16_t *before) {
+    uint16_t n = 0;
+    for (uint16_t i = 0; i < TILE_COUNT; i++) {
+        uint16_t x0 = (i % TILE_COLS) * TILE_SIZE;
+        uint16_t y0 = (i / TILE_COLS) * TILE_SIZE;
+        bool diff = false;
+        for (uint16_t y = y0; y < y0 + TILE_SIZE && y < TFT_HEIGHT && !diff; y++) {
+            uint16_t w = TFT_WIDTH - x0 < TILE_SIZE ? TFT_WIDTH - x0 : TILE_SIZE;
+            diff = memcmp(&before[y * TFT_WIDTH + x0], &ref_pixels[y * TFT_WIDTH + x0],
+                          w * sizeof(uint16_t)) != 0;
+        }
+        n += diff;
+    }
+    return n;
+}
+
+int main(void) {
+    tft_bus_init();
+    if (!display_list_init(&scene, TFT_WIDTH, TFT_HEIGHT, 16)) return 1;
+
+    static const uint16_t colors[] = {COLOR_WHITE, COLOR_BLUE, COLOR_GREEN, COLOR_ORANGE,
+                                      COLOR_BLACK, COLOR_RED, COLOR_YELLOW};
+    for (uint8_t i = 0; i < sizeof(colors) / sizeof(colors[0]); i++) {
+        display_list_set_color(&scene, i, colors[i]);
+    }
+
+    printf("First frame\n");
+    tiles_init(&tr);
+    record(100, 200);
+    render_reference();
+    tiles_render(&tr, &scene);
+    check(panel_matches(), "panel matches a full-screen render");
+    check(tiles_stats(&tr)->rendered == TILE_COUNT, "every tile rendered");
+    check(tiles_stats(&tr)->sent == TILE_COUNT, "every tile sent");
+
+    printf("Unchanged frame\n");
+    tiles_render(&tr, &scene);
+    check(tiles_stats(&tr)->rendered == 0, "no tile rendered");
+    check(tiles_stats(&tr)->sent == 0, "no tile sent");
+
+    printf("Ball moved\n");
+    static uint16_t before[TFT_WIDTH * TFT_HEIGHT];
+    memcpy(before, ref_pixels, sizeof(before));
+    record(112, 206);
+    render_reference();
+    uint16_t expected = changed_tiles(before);
+    tiles_render(&tr, &scene);
+    printf("  %u of %u tiles changed, %u sent\n", expected, TILE_COUNT, tiles_stats(&tr)->sent);
+    check(panel_matches(), "panel matches a full-screen render");
+    check(tiles_stats(&tr)->rendered == TILE_COUNT, "every tile rendered");
+    check(expected > 0 && tiles_stats(&tr)->sent == expected, "only changed tiles sent");
+
+    printf("Area drawn over and invalidated\n");
+    tft_fill_rect(70, 90, 50, 40, COLOR_MAGENTA);
+    tiles_invalidate(&tr, 70, 90, 50, 40);
+    tiles_render(&tr, &scene);
+    uint16_t covered = ((70 + 50 - 1) / TILE_SIZE - 70 / TILE_SIZE + 1) *
+                       ((90 + 40 - 1) / TILE_SIZE - 90 / TILE_SIZE + 1);
+    check(panel_matches(), "panel restored");
+    check(tiles_stats(&tr)->rendered == covered, "only invalidated tiles rendered");
+    check(tiles_stats(&tr)->sent == covered, "invalidated tiles sent despite equal hashes");
+
+    return ok ? 0 : 1;
+}
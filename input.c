@@ -0,0 +1,96 @@
+#include "input.h"
+#include "spsc.h"
+#include "pico/stdlib.h"
+#include "hardware/gpio.h"
+
+#define EVENT_QUEUE_LEN 32
+
+static uint32_t input_mask;
+static repeating_timer_t scan_timer;
+
+// Debounce state: two-bit vertical counter per input
+static uint32_t cnt0;
+static uint32_t cnt1;
+static volatile uint32_t debounced;
+
+// Per-input timing
+static uint64_t edge_time[32];      // First sample of the pending change
+static uint64_t next_repeat[32];
+
+static input_event_t event_storage[EVENT_QUEUE_LEN];
+static spsc_t event_queue;
+
+static void queue_event(uint8_t gpio, uint8_t type, uint64_t time_us) {
+    input_event_t event = {time_us, gpio, type};
+    spsc_push(&event_queue, &event);
+}
+
+static bool input_scan(repeating_timer_t *rt) {
+    uint64_t now = time_us_64();
+
+    // One read for every input; pressed buttons pull low
+    uint32_t sample = ~gpio_get_all() & input_mask;
+
+    // Each bit of delta counts 0..3 in (cnt1:cnt0) and resets whenever
+    // the sample agrees with the debounced state again
+    uint32_t delta = sample ^ debounced;
+    uint32_t started = delta & ~(cnt0 | cnt1);
+    cnt1 = (cnt1 ^ cnt0) & delta;
+    cnt0 = ~cnt0 & delta;
+    uint32_t toggled = delta & ~(cnt0 | cnt1);
+
+    // Remember when each new change was first seen
+    started &= cnt0;
+    while (started) {
+        uint8_t gpio = __builtin_ctz(started);
+        edge_time[gpio] = now;
+        started &= started - 1;
+    }
+
+    if (toggled) {
+        debounced ^= toggled;
+        while (toggled) {
+            uint8_t gpio = __builtin_ctz(toggled);
+            bool pressed = debounced & (1u << gpio);
+            queue_event(gpio, pressed ? INPUT_PRESS : INPUT_RELEASE, edge_time[gpio]);
+            next_repeat[gpio] = edge_time[gpio] + INPUT_REPEAT_DELAY_US;
+            toggled &= toggled - 1;
+        }
+    }
+
+    // Auto-repeat for anything still held
+    uint32_t held = debounced;
+    while (held) {
+        uint8_t gpio = __builtin_ctz(held);
+        if (now >= next_repeat[gpio]) {
+            queue_event(gpio, INPUT_REPEAT, now);
+            next_repeat[gpio] += INPUT_REPEAT_PERIOD_US;
+        }
+        held &= held - 1;
+    }
+
+    return true;
+}
+
+void input_init(uint32_t gpio_mask) {
+    input_mask = gpio_mask;
+
+    gpio_init_mask(gpio_mask);
+    gpio_set_dir_in_masked(gpio_mask);
+    for (uint8_t gpio = 0; gpio < 32; gpio++) {
+        if (gpio_mask & (1u << gpio)) {
+            gpio_pull_up(gpio);
+        }
+    }
+
+    spsc_init(&event_queue, event_storage, sizeof(input_event_t), EVENT_QUEUE_LEN);
+    add_repeating_timer_us(-INPUT_SCAN_US, input_scan, NULL, &scan_timer);
+}
+
+bool input_poll_event(input_event_t *event) {
+    return spsc_pop(&event_queue, event);
+}
+
+uint32_t input_state(void) {
+    return debounced;
+}
@@ -0,0 +1,37 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Inputs are sampled every INPUT_SCAN_US; a change must hold for four
+// consecutive samples before it is reported
+#define INPUT_SCAN_US       1000
+
+// Auto-repeat for held inputs
+#define INPUT_REPEAT_DELAY_US   400000
+#define INPUT_REPEAT_PERIOD_US  100000
+
+typedef enum {
+    INPUT_PRESS,
+    INPUT_RELEASE,
+    INPUT_REPEAT
+} input_event_type_t;
+
+typedef struct {
+    uint64_t time_us;         // Sample where the reported change began
+    uint8_t gpio;
+    uint8_t type;             // input_event_type_t
+} input_event_t;
+
+// Configure every pin in `gpio_mask` as an active-low input with pull-up
+// and start the scan timer
+void input_init(uint32_t gpio_mask);
+
+// Drain the next queued event; returns false when the queue is empty
+bool input_poll_event(input_event_t *event);
+
+// Debounced pressed state, one bit per GPIO
+uint32_t input_state(void);
+
+#endif // INPUT_H
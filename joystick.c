@@ -0,0 +1,162 @@
+#include "joystick.h"
+#include "fixed.h"
+#include "pico/stdlib.h"
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+
+// Onboard Joystick (Analog)
+#define JOY_ONBOARD_X   26  // ADC0
+#define JOY_ONBOARD_Y   27  // ADC1
+
+// Round-robin over both inputs: 8 kS/s total, 4 kS/s per axis
+#define ADC_CLOCK_HZ    48000000
+#define ADC_SAMPLE_HZ   8000
+
+// Ring of interleaved X/Y samples written by DMA. Its length must be even
+// (so index parity gives the axis) and a power of two for the DMA ring.
+#define RING_LEN        64
+#define RING_BITS       7       // log2(RING_LEN * sizeof(uint16_t))
+
+// The filter runs from a timer: each tick averages the whole ring (a
+// decimating boxcar over the last 8 ms) and feeds a one-pole low-pass
+#define FILTER_US       1000
+#define FILTER_SHIFT    2       // y += (x - y) / 4
+#define FILTER_SCALE    16      // Filter state is in 1/16 ADC counts
+
+// Assumed travel before the stick has been seen further out
+#define DEFAULT_RANGE   1800
+
+static uint16_t ring[RING_LEN] __attribute__((aligned(RING_LEN * sizeof(uint16_t))));
+
+// Written back into the data channel each time it finishes, so sampling
+// never stops
+static uint32_t reload_count = RING_LEN * 4096;
+
+static int data_chan = -1;
+static int ctrl_chan = -1;
+static repeating_timer_t filter_timer;
+
+// Calibration and filter state, all in 1/16 ADC counts
+static int32_t filt_x, filt_y;
+static int32_t center_x, center_y;
+static int32_t min_x, max_x;
+static int32_t min_y, max_y;
+
+// Published results, packed so a read is a single load
+static volatile uint32_t state;
+static volatile uint32_t raw_state;
+
+// Map a filtered reading onto -JOYSTICK_MAX..JOYSTICK_MAX using separate
+// extents on either side of the center
+static int32_t normalize(int32_t v, int32_t center, int32_t lo, int32_t hi) {
+    if (v >= center) {
+        return (int32_t)((int64_t)(v - center) * JOYSTICK_MAX / (hi - center));
+    }
+    return -(int32_t)((int64_t)(center - v) * JOYSTICK_MAX / (center - lo));
+}
+
+static void ring_average(int32_t *x, int32_t *y) {
+    uint32_t sum_x = 0;
+    uint32_t sum_y = 0;
+    for (uint8_t i = 0; i < RING_LEN; i += 2) {
+        sum_x += ring[i];
+        sum_y += ring[i + 1];
+    }
+    *x = (int32_t)(sum_x * FILTER_SCALE / (RING_LEN / 2));
+    *y = (int32_t)(sum_y * FILTER_SCALE / (RING_LEN / 2));
+}
+
+static bool joystick_filter(repeating_timer_t *rt) {
+    int32_t avg_x, avg_y;
+    ring_average(&avg_x, &avg_y);
+
+    filt_x += (avg_x - filt_x) >> FILTER_SHIFT;
+    filt_y += (avg_y - filt_y) >> FILTER_SHIFT;
+
+    // Extents grow to whatever travel the stick actually has
+    if (filt_x < min_x) min_x = filt_x;
+    if (filt_x > max_x) max_x = filt_x;
+    if (filt_y < min_y) min_y = filt_y;
+    if (filt_y > max_y) max_y = filt_y;
+
+    int32_t nx = normalize(filt_x, center_x, min_x, max_x);
+    int32_t ny = normalize(filt_y, center_y, min_y, max_y);
+
+    // Radial dead zone, rescaled so output still starts at zero at its edge
+    uint32_t mag = isqrt32((uint32_t)(nx * nx + ny * ny));
+    if (mag <= JOYSTICK_DEAD_ZONE) {
+        nx = 0;
+        ny = 0;
+    } else {
+        int32_t scaled = (int32_t)(mag - JOYSTICK_DEAD_ZONE) * JOYSTICK_MAX /
+                         (JOYSTICK_MAX - JOYSTICK_DEAD_ZONE);
+        if (scaled > JOYSTICK_MAX) scaled = JOYSTICK_MAX;
+        nx = nx * scaled / (int32_t)mag;
+        ny = ny * scaled / (int32_t)mag;
+    }
+
+    state = (uint16_t)nx | ((uint32_t)(uint16_t)ny << 16);
+    raw_state = (uint16_t)(filt_x / FILTER_SCALE) |
+                ((uint32_t)(uint16_t)(filt_y / FILTER_SCALE) << 16);
+    return true;
+}
+
+void joystick_init(void) {
+    adc_init();
+    adc_gpio_init(JOY_ONBOARD_X);
+    adc_gpio_init(JOY_ONBOARD_Y);
+
+    // Free-running conversions alternating ADC0, ADC1 into the FIFO
+    adc_select_input(0);
+    adc_set_round_robin((1u << 0) | (1u << 1));
+    adc_fifo_setup(true, true, 1, false, false);
+    adc_set_clkdiv((float)ADC_CLOCK_HZ / ADC_SAMPLE_HZ - 1);
+
+    // Data channel drains the FIFO into the ring; when its count runs out
+    // it chains to a control channel that re-arms it
+    data_chan = dma_claim_unused_channel(true);
+    ctrl_chan = dma_claim_unused_channel(true);
+
+    dma_channel_config c = dma_channel_get_default_config(data_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_ring(&c, true, RING_BITS);
+    channel_config_set_dreq(&c, DREQ_ADC);
+    channel_config_set_chain_to(&c, ctrl_chan);
+    dma_channel_configure(data_chan, &c, ring, &adc_hw->fifo, reload_count, false);
+
+    c = dma_channel_get_default_config(ctrl_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, false);
+    dma_channel_configure(ctrl_chan, &c, &dma_hw->ch[data_chan].al1_transfer_count_trig,
+                          &reload_count, 1, false);
+
+    dma_channel_start(data_chan);
+    adc_run(true);
+
+    // Let the ring fill, then take the rest position as the center
+    sleep_ms(20);
+    ring_average(&filt_x, &filt_y);
+    center_x = filt_x;
+    center_y = filt_y;
+    min_x = center_x - DEFAULT_RANGE * FILTER_SCALE;
+    max_x = center_x + DEFAULT_RANGE * FILTER_SCALE;
+    min_y = center_y - DEFAULT_RANGE * FILTER_SCALE;
+    max_y = center_y + DEFAULT_RANGE * FILTER_SCALE;
+
+    add_repeating_timer_us(-FILTER_US, joystick_filter, NULL, &filter_timer);
+}
+
+joystick_t joystick_read(void) {
+    uint32_t packed = state;
+    joystick_t joy = {(int16_t)(packed & 0xFFFF), (int16_t)(packed >> 16)};
+    return joy;
+}
+
+void joystick_read_raw(uint16_t *x, uint16_t *y) {
+    uint32_t packed = raw_state;
+    *x = packed & 0xFFFF;
+    *y = packed >> 16;
+}
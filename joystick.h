@@ -0,0 +1,28 @@
+#ifndef JOYSTICK_H
+#define JOYSTICK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Full deflection after calibration
+#define JOYSTICK_MAX        32767
+
+// Radial dead zone, as a fraction of JOYSTICK_MAX
+#define JOYSTICK_DEAD_ZONE  3300
+
+typedef struct {
+    int16_t x;                // -JOYSTICK_MAX..JOYSTICK_MAX, 0 inside the dead zone
+    int16_t y;
+} joystick_t;
+
+// Start free-running ADC sampling of both axes and calibrate the center.
+// The stick must be at rest while this runs.
+void joystick_init(void);
+
+// Latest filtered, calibrated state; just a memory read
+joystick_t joystick_read(void);
+
+// Filtered ADC values before calibration (0-4095), for diagnostics
+void joystick_read_raw(uint16_t *x, uint16_t *y);
+
+#endif // JOYSTICK_H
@@ -4,25 +4,24 @@
  */
 
 #include <stdio.h>
-#include <math.h>
 #include "pico/stdlib.h"
 #include "pico/cyw43_arch.h"
 #include "hardware/i2c.h"
 #include "hardware/gpio.h"
-#include "hardware/pwm.h"
-#include "hardware/adc.h"
 #include "display.h"
+#include "render.h"
+#include "displaylist.h"
+#include "scheduler.h"
+#include "touch.h"
+#include "input.h"
+#include "joystick.h"
+#include "audio.h"
+#include "entity.h"
+#include "anim.h"
+#include "trace.h"
 
 // ===== HARDWARE PIN DEFINITIONS =====
 
-// Touch Screen - I2C (GT911)
-#define TOUCH_I2C       i2c0
-#define TOUCH_SDA       8
-#define TOUCH_SCL       9
-#define GT911_ADDR      0x5D
-#define GT911_STATUS    0x814E
-#define GT911_POINT1    0x814F
-
 // Buzzer
 #define BUZZER_PIN      13
 
@@ -33,10 +32,6 @@
 #define BTN1_PIN        15
 #define BTN2_PIN        14
 
-// Onboard Joystick (Analog)
-#define JOY_ONBOARD_X   26  // ADC0
-#define JOY_ONBOARD_Y   27  // ADC1
-
 // Extra Joystick 2 (Digital: 4 directions + button)
 #define JOY2_UP         18
 #define JOY2_DOWN       19
@@ -51,146 +46,113 @@
 #define JOY3_RIGHT      10
 #define JOY3_BTN        11
 
+// All digital inputs, scanned together by the input module
+#define INPUT_PINS      ((1u << BTN1_PIN) | (1u << BTN2_PIN) | \
+                         (1u << JOY2_UP) | (1u << JOY2_DOWN) | (1u << JOY2_LEFT) | \
+                         (1u << JOY2_RIGHT) | (1u << JOY2_BTN) | \
+                         (1u << JOY3_UP) | (1u << JOY3_DOWN) | (1u << JOY3_LEFT) | \
+                         (1u << JOY3_RIGHT) | (1u << JOY3_BTN))
+
 // Status LEDs
 #define LED_D1          16
 #define LED_D2          17
 
-// ===== HELPER FUNCTIONS =====
+// ===== TIMING =====
 
-void play_tone(uint frequency_hz, uint duration_ms) {
-    uint slice_num = pwm_gpio_to_slice_num(BUZZER_PIN);
+#define UPDATE_HZ       100     // Fixed game/input step
+#define FRAME_HZ        50      // Target render rate
+#define HEARTBEAT_MS    25      // LED on/off time
 
-    // Set PWM frequency
-    uint32_t clock = 125000000; // 125 MHz system clock
-    uint32_t divider = clock / (frequency_hz * 4096);
-    pwm_set_clkdiv(slice_num, divider);
+// Full joystick deflection moves the smiley JOY_MAX_SPEED px per MOVE_TICK_US
+#define JOY_MAX_SPEED   20
+#define MOVE_TICK_US    50000
 
-    // Set 50% duty cycle
-    pwm_set_wrap(slice_num, 4095);
-    pwm_set_gpio_level(BUZZER_PIN, 2048);
+// Hop played on a mood change: up quickly, easing off, then falling back
+static const anim_key_t hop_keys[] = {
+    {0,   0,   ANIM_LINEAR},
+    {120, -12, ANIM_EASE_OUT},
+    {300, 0,   ANIM_EASE_IN},
+};
 
-    // Enable PWM
-    pwm_set_enabled(slice_num, true);
-    sleep_ms(duration_ms);
+// Touch and hold steps through the colors this often
+#define COLOR_CYCLE_MS  150
 
-    // Disable PWM (silence)
-    pwm_set_enabled(slice_num, false);
-}
+// ===== GAME STATE =====
+
+#define MAX_ENTITIES    32
+
+// Everything that moves on screen; for now just the smiley
+static entity_world_t world;
 
 // ===== SCREEN DRAWING FUNCTIONS =====
 
-void draw_smiley_face_to_sprite(sprite_t *sprite, bool is_happy, uint16_t face_color) {
-    // Clear sprite with white background
-    sprite_fill(sprite, COLOR_WHITE);
+// Palette slots used by the smiley scene
+enum {
+    FACE_PAPER,
+    FACE_SKIN,
+    FACE_INK
+};
+
+// Frames of the smiley, one per mood
+enum {
+    FACE_HAPPY,
+    FACE_SAD,
+    FACE_FRAMES
+};
+
+// Each mood is recorded once and kept rasterized; position, color and
+// mood changes only cost a palette expansion, or nothing at all
+static anim_cache_t faces;
+
+void record_smiley_face(display_list_t *dl, bool is_happy) {
+    display_list_clear(dl);
+
+    // White background
+    display_list_fill(dl, FACE_PAPER);
 
     // Face (colored circle at center of sprite)
-    uint16_t center_x = sprite->width / 2;
-    uint16_t center_y = sprite->height / 2;
-    uint16_t face_radius = 100;
+    int16_t center_x = dl->width / 2;
+    int16_t center_y = dl->height / 2;
+    int16_t face_radius = 100;
 
-    sprite_fill_circle(sprite, center_x, center_y, face_radius, face_color);
+    display_list_circle(dl, center_x, center_y, face_radius, FACE_SKIN);
 
     // Left eye
-    sprite_fill_circle(sprite, center_x - 35, center_y - 30, 10, COLOR_BLACK);
+    display_list_circle(dl, center_x - 35, center_y - 30, 10, FACE_INK);
 
     // Right eye
-    sprite_fill_circle(sprite, center_x + 35, center_y - 30, 10, COLOR_BLACK);
+    display_list_circle(dl, center_x + 35, center_y - 30, 10, FACE_INK);
 
-    // Mouth (happy smile or sad frown)
+    // Mouth (happy smile or sad frown), an arc made of small circles
     if (is_happy) {
-        // Smile (arc made of small circles)
-        for (int angle = 20; angle <= 160; angle += 5) {
-            float rad = angle * 3.14159 / 180.0;
-            int16_t x = center_x + (int16_t)(50 * cos(rad));
-            int16_t y = center_y + (int16_t)(50 * sin(rad));
-            sprite_fill_circle(sprite, x, y, 3, COLOR_BLACK);
-        }
+        display_list_arc_dots(dl, center_x, center_y, 50, 20, 160, 5, 3, FACE_INK);
     } else {
-        // Frown (inverted arc)
-        for (int angle = 200; angle <= 340; angle += 5) {
-            float rad = angle * 3.14159 / 180.0;
-            int16_t x = center_x + (int16_t)(50 * cos(rad));
-            int16_t y = center_y + 20 + (int16_t)(50 * sin(rad));
-            sprite_fill_circle(sprite, x, y, 3, COLOR_BLACK);
-        }
+        display_list_arc_dots(dl, center_x, center_y + 20, 50, 200, 340, 5, 3, FACE_INK);
     }
 }
 
-// ===== INITIALIZATION FUNCTIONS =====
-
-void init_touch() {
-    // Initialize I2C for touch
-    i2c_init(TOUCH_I2C, 400 * 1000); // 400 kHz
-    gpio_set_function(TOUCH_SDA, GPIO_FUNC_I2C);
-    gpio_set_function(TOUCH_SCL, GPIO_FUNC_I2C);
-    gpio_pull_up(TOUCH_SDA);
-    gpio_pull_up(TOUCH_SCL);
-
-    printf("Touch GT911 initialized\n");
+void record_face_frame(display_list_t *dl, uint8_t frame, void *ctx) {
+    record_smiley_face(dl, frame == FACE_HAPPY);
 }
 
-bool read_touch(uint16_t *x, uint16_t *y) {
-    // Read GT911 status register
-    uint8_t reg[2] = {(GT911_STATUS >> 8) & 0xFF, GT911_STATUS & 0xFF};
-    uint8_t status;
-
-    // Write register address
-    if (i2c_write_blocking(TOUCH_I2C, GT911_ADDR, reg, 2, true) < 0) {
-        return false;
-    }
-
-    // Read status
-    if (i2c_read_blocking(TOUCH_I2C, GT911_ADDR, &status, 1, false) < 0) {
-        return false;
-    }
-
-    // Check if touch detected (bit 7 = buffer status, bits 0-3 = touch points)
-    uint8_t touch_points = status & 0x0F;
-    if (touch_points == 0) {
-        return false; // No touch
-    }
-
-    // Read touch point data
-    reg[0] = (GT911_POINT1 >> 8) & 0xFF;
-    reg[1] = GT911_POINT1 & 0xFF;
-
-    if (i2c_write_blocking(TOUCH_I2C, GT911_ADDR, reg, 2, true) < 0) {
-        return false;
-    }
-
-    uint8_t data[6];
-    if (i2c_read_blocking(TOUCH_I2C, GT911_ADDR, data, 6, false) < 0) {
-        return false;
-    }
-
-    // Parse coordinates (little endian)
-    *x = data[0] | (data[1] << 8);
-    *y = data[2] | (data[3] << 8);
-
-    // Clear status register
-    uint8_t clear_buf[3] = {(GT911_STATUS >> 8) & 0xFF, GT911_STATUS & 0xFF, 0};
-    i2c_write_blocking(TOUCH_I2C, GT911_ADDR, clear_buf, 3, false);
-
-    return true;
+// Render callback, runs on core1
+void draw_frame(sprite_t *sprite, const frame_desc_t *frame) {
+    anim_cache_set_color(&faces, FACE_SKIN, frame->face_color);
+    anim_cache_draw(&faces, frame->is_happy ? FACE_HAPPY : FACE_SAD, sprite);
 }
 
-void init_buttons() {
-    gpio_init(BTN1_PIN);
-    gpio_set_dir(BTN1_PIN, GPIO_IN);
-    gpio_pull_up(BTN1_PIN);
+// ===== INITIALIZATION FUNCTIONS =====
 
-    gpio_init(BTN2_PIN);
-    gpio_set_dir(BTN2_PIN, GPIO_IN);
-    gpio_pull_up(BTN2_PIN);
+void init_buttons() {
+    // Buttons and both digital joysticks, debounced from a timer
+    input_init(INPUT_PINS);
 
     printf("Buttons initialized\n");
 }
 
 void init_buzzer() {
-    gpio_init(BUZZER_PIN);
-    gpio_set_function(BUZZER_PIN, GPIO_FUNC_PWM);
-    uint slice_num = pwm_gpio_to_slice_num(BUZZER_PIN);
-    pwm_set_enabled(slice_num, true);
+    // PWM DAC fed from DMA; notes play in the background
+    audio_init(BUZZER_PIN);
 
     printf("Buzzer initialized\n");
 }
@@ -203,52 +165,10 @@ void init_rgb_led() {
 }
 
 void init_joysticks() {
-    // Onboard analog joystick
-    adc_init();
-    adc_gpio_init(JOY_ONBOARD_X);
-    adc_gpio_init(JOY_ONBOARD_Y);
-
-    // Extra joystick 2 (digital)
-    gpio_init(JOY2_UP);
-    gpio_set_dir(JOY2_UP, GPIO_IN);
-    gpio_pull_up(JOY2_UP);
-
-    gpio_init(JOY2_DOWN);
-    gpio_set_dir(JOY2_DOWN, GPIO_IN);
-    gpio_pull_up(JOY2_DOWN);
-
-    gpio_init(JOY2_LEFT);
-    gpio_set_dir(JOY2_LEFT, GPIO_IN);
-    gpio_pull_up(JOY2_LEFT);
-
-    gpio_init(JOY2_RIGHT);
-    gpio_set_dir(JOY2_RIGHT, GPIO_IN);
-    gpio_pull_up(JOY2_RIGHT);
-
-    gpio_init(JOY2_BTN);
-    gpio_set_dir(JOY2_BTN, GPIO_IN);
-    gpio_pull_up(JOY2_BTN);
+    // Onboard analog joystick, sampled and filtered in the background
+    joystick_init();
 
-    // Extra joystick 3 (digital)
-    gpio_init(JOY3_UP);
-    gpio_set_dir(JOY3_UP, GPIO_IN);
-    gpio_pull_up(JOY3_UP);
-
-    gpio_init(JOY3_DOWN);
-    gpio_set_dir(JOY3_DOWN, GPIO_IN);
-    gpio_pull_up(JOY3_DOWN);
-
-    gpio_init(JOY3_LEFT);
-    gpio_set_dir(JOY3_LEFT, GPIO_IN);
-    gpio_pull_up(JOY3_LEFT);
-
-    gpio_init(JOY3_RIGHT);
-    gpio_set_dir(JOY3_RIGHT, GPIO_IN);
-    gpio_pull_up(JOY3_RIGHT);
-
-    gpio_init(JOY3_BTN);
-    gpio_set_dir(JOY3_BTN, GPIO_IN);
-    gpio_pull_up(JOY3_BTN);
+    // Extra joysticks 2 and 3 are digital and scanned with the buttons
 
     printf("Joysticks initialized (1 analog + 2 digital)\n");
 }
@@ -271,6 +191,7 @@ int main() {
     sleep_ms(2000); // Wait for USB serial
 
     printf("\n=== Lil Guy Starting ===\n");
+    TRACE_INIT();
 
     // Initialize WiFi
     if (cyw43_arch_init()) {
@@ -281,7 +202,12 @@ int main() {
 
     // Initialize all hardware
     display_init();
-    init_touch();
+#ifdef TFT_BENCHMARK
+    display_benchmark();
+#endif
+    if (!touch_init()) {
+        printf("Touch unavailable, continuing without it\n");
+    }
     init_buttons();
     init_buzzer();
     init_rgb_led();
@@ -290,16 +216,41 @@ int main() {
 
     printf("=== Hardware Ready ===\n\n");
 
-    // Create sprite buffer for smiley (220x220 to fit face + padding)
+    // Clear screen once, before core1 takes over the display
+    tft_fill_rect(0, 0, TFT_WIDTH, TFT_HEIGHT, COLOR_WHITE);
+
+    // Smiley frames (220x220 to fit face + padding)
     const uint16_t sprite_size = 220;
-    sprite_t *smiley_sprite = sprite_create(sprite_size, sprite_size);
-    if (!smiley_sprite) {
+    if (!anim_cache_init(&faces, FACE_FRAMES, sprite_size, sprite_size, 48, record_face_frame, NULL)) {
+        printf("Failed to create display list!\n");
+        return -1;
+    }
+    anim_cache_set_color(&faces, FACE_PAPER, COLOR_WHITE);
+    anim_cache_set_color(&faces, FACE_INK, COLOR_BLACK);
+
+    // Rasterized here, while arena_static is still core0's alone, so core1
+    // only ever expands them
+    if (!anim_cache_prepare(&faces)) {
+        printf("Failed to rasterize smiley frames!\n");
+        return -1;
+    }
+
+    // Start the core1 renderer with double-buffered sprites for the smiley
+    if (!render_init(sprite_size, sprite_size, COLOR_WHITE, draw_frame)) {
         printf("Failed to create sprite buffer!\n");
         return -1;
     }
 
-    // Clear screen once
-    tft_fill_rect(0, 0, TFT_WIDTH, TFT_HEIGHT, COLOR_WHITE);
+    // The world ends above the HUD strip, so confining the smiley to it
+    // keeps the two apart
+    if (!entity_world_init(&world, &arena_static, MAX_ENTITIES, TFT_WIDTH, TFT_HEIGHT - RENDER_HUD_HEIGHT)) {
+        printf("Failed to create entity world!\n");
+        return -1;
+    }
+
+    const arena_stats_t *mem = arena_stats(&arena_static);
+    printf("Static arena: %lu of %lu bytes used, %lu at peak\n", (unsigned long)mem->used,
+           (unsigned long)mem->size, (unsigned long)mem->high_water);
 
     // Smiley face state variables
     bool is_happy = true;
@@ -308,138 +259,167 @@ int main() {
     uint8_t num_colors = 7;
 
     // Position tracking (start at center)
-    int16_t smiley_x = TFT_WIDTH / 2 - sprite_size / 2;
-    int16_t smiley_y = TFT_HEIGHT / 2 - sprite_size / 2;
-    int16_t old_x = smiley_x;
-    int16_t old_y = smiley_y;
+    entity_id_t smiley = entity_spawn(&world, TFT_WIDTH / 2 - sprite_size / 2,
+                                      TFT_HEIGHT / 2 - sprite_size / 2, sprite_size, sprite_size);
+    entity_hash_build(&world);
     const int16_t face_radius = 100;
 
-    // Button state tracking for debouncing
-    bool btn1_last = false;
-    bool btn2_last = false;
+    // Touch and hold: colors advance from the one showing at touch down
+    anim_clip_t color_cycle = {num_colors, COLOR_CYCLE_MS, ANIM_LOOP};
+    bool touch_held = false;
+    uint64_t hold_start_us = 0;
+    uint8_t hold_base = 0;
 
-    // Touch state tracking
-    bool touch_active = false;
-    uint32_t last_color_change = 0;
+    // Mood change hop, as a vertical offset
+    anim_tween_t hop = {0};
+    int32_t hop_y = 0;
 
     // Draw initial smiley face
-    draw_smiley_face_to_sprite(smiley_sprite, is_happy, rainbow_colors[color_index]);
-    sprite_push(smiley_sprite, smiley_x, smiley_y);
+    uint16_t slot = entity_slot(&world, smiley);
+    frame_desc_t frame = {q16_floor(world.x[slot]), q16_floor(world.y[slot]), is_happy, rainbow_colors[color_index]};
+    render_post(&frame);
+    bool frame_pending = false;
     printf("Smiley face drawn! BTN1=toggle happy/sad, BTN2=change color, Joystick=move, Touch=cycle colors\n");
 
+    // Heartbeat LEDs blink from timers, not from the loop
+    scheduler_heartbeat_start(LED_D1, HEARTBEAT_MS);
+    scheduler_init(UPDATE_HZ, FRAME_HZ);
+
+    // Sub-pixel joystick motion carried between update steps (1/256 px)
+    int32_t frac_x = 0;
+    int32_t frac_y = 0;
+    bool needs_redraw = false;
+
     // Main loop
     while (true) {
-        // Blink LEDs to show we're alive
-        gpio_put(LED_D1, 1);
-        cyw43_arch_gpio_put(CYW43_WL_GPIO_LED_PIN, 1);
-        sleep_ms(25);
-
-        gpio_put(LED_D1, 0);
-        cyw43_arch_gpio_put(CYW43_WL_GPIO_LED_PIN, 0);
-        sleep_ms(25);
-
-        // Read button states (buttons read LOW when pressed)
-        bool btn1_pressed = !gpio_get(BTN1_PIN);
-        bool btn2_pressed = !gpio_get(BTN2_PIN);
-
-        bool needs_redraw = false;
-
-        // BTN1: Toggle happy/sad on button press (edge detection)
-        if (btn1_pressed && !btn1_last) {
-            is_happy = !is_happy;
-            needs_redraw = true;
-            // Play a very gentle, low tone (200 Hz for 80ms - much softer)
-            play_tone(200, 80);
-            printf("Toggled mood: %s\n", is_happy ? "Happy :)" : "Sad :(");
-        }
-        btn1_last = btn1_pressed;
-
-        // BTN2: Cycle through colors on button press (edge detection)
-        if (btn2_pressed && !btn2_last) {
-            color_index = (color_index + 1) % num_colors;
-            needs_redraw = true;
-            printf("Changed color to index %d\n", color_index);
-        }
-        btn2_last = btn2_pressed;
+        scheduler_begin_frame();
+
+        // ----- Fixed-step update -----
+        while (scheduler_update_due()) {
+            TRACE_ZONE(UPDATE);
+
+            // Buttons: act on debounced press events
+            TRACE_BEGIN(INPUT);
+            input_event_t input_event;
+            while (input_poll_event(&input_event)) {
+                if (input_event.type != INPUT_PRESS) continue;
+
+                // BTN1: Toggle happy/sad
+                if (input_event.gpio == BTN1_PIN) {
+                    is_happy = !is_happy;
+                    needs_redraw = true;
+                    anim_tween_play(&hop, hop_keys, 3, ANIM_ONCE, time_us_64());
+                    // Play a very gentle, low tone (200 Hz for 80ms - much softer)
+                    audio_play(200, 80, 255);
+                    printf("Toggled mood: %s\n", is_happy ? "Happy :)" : "Sad :(");
+                }
+
+                // BTN2: Cycle through colors
+                if (input_event.gpio == BTN2_PIN) {
+                    color_index = (color_index + 1) % num_colors;
+                    needs_redraw = true;
+                    printf("Changed color to index %d\n", color_index);
+                }
+            }
 
-        // Touch: Cycle through colors fluidly while held
-        uint16_t touch_x, touch_y;
-        bool is_touched = read_touch(&touch_x, &touch_y);
+            // Touch: drain events; they are read in the background only
+            // when the controller signals a report
+            touch_event_t touch_event;
+            while (touch_poll_event(&touch_event)) {
+                if (touch_event.type == TOUCH_DOWN) {
+                    bool on_smiley = entity_hit_test(&world, touch_event.x, touch_event.y) == smiley;
+                    printf("Touch %d down at %d,%d%s\n", touch_event.id, touch_event.x, touch_event.y,
+                           on_smiley ? " (smiley)" : "");
+                }
+            }
 
-        if (is_touched) {
-            // Blink D2 LED to show touch is detected
-            gpio_put(LED_D2, 1);
+            // Cycle through colors fluidly while held, paced by how long
+            // the touch has lasted rather than by loop passes
+            uint64_t now_us = time_us_64();
+            if (touch_active_count() > 0) {
+                // Blink D2 LED to show touch is detected
+                gpio_put(LED_D2, 1);
+
+                if (!touch_held) {
+                    touch_held = true;
+                    hold_start_us = now_us;
+                    hold_base = color_index;
+                }
+                uint32_t held_ms = (uint32_t)((now_us - hold_start_us) / 1000);
+                uint8_t next = (hold_base + 1 + anim_clip_frame(&color_cycle, held_ms)) % num_colors;
+                if (next != color_index) {
+                    color_index = next;
+                    needs_redraw = true;
+                }
+            } else {
+                touch_held = false;
+                gpio_put(LED_D2, 0);
+            }
 
-            // Cycle colors every 150ms while holding touch
-            uint32_t now = to_ms_since_boot(get_absolute_time());
-            if (now - last_color_change > 150) {
-                color_index = (color_index + 1) % num_colors;
+            int32_t hop_now = anim_tween_value(&hop, now_us);
+            if (hop_now != hop_y) {
+                hop_y = hop_now;
+                needs_redraw = true;
+            }
+            TRACE_END(INPUT);
+
+            // Onboard analog joystick: already filtered, calibrated and
+            // dead-zoned, so this is just a read of the latest state
+            TRACE_BEGIN(JOYSTICK);
+            joystick_t joy = joystick_read();
+            TRACE_END(JOYSTICK);
+
+            // Scale to pixels for this update step, carrying the sub-pixel
+            // remainder (1/256 px). The stick is mounted a quarter turn
+            // from the portrait panel: in portrait X moves vertically and
+            // Y horizontally, in landscape the axes line up.
+            int32_t step_us = (int32_t)scheduler_step_us();
+            int32_t move_x = (int32_t)joy.x * JOY_MAX_SPEED * 256 / JOYSTICK_MAX * step_us / MOVE_TICK_US;
+            int32_t move_y = (int32_t)joy.y * JOY_MAX_SPEED * 256 / JOYSTICK_MAX * step_us / MOVE_TICK_US;
+#ifdef TFT_LANDSCAPE
+            frac_x += move_x;
+            frac_y += move_y;
+#else
+            frac_x -= move_y;
+            frac_y += move_x;
+#endif
+            int16_t dx = frac_x / 256;
+            int16_t dy = frac_y / 256;
+            frac_x -= dx * 256;
+            frac_y -= dy * 256;
+
+            if (dx != 0 || dy != 0) {
+                slot = entity_slot(&world, smiley);
+                world.x[slot] += q16_from_int(dx);
+                world.y[slot] += q16_from_int(dy);
                 needs_redraw = true;
-                last_color_change = now;
             }
-            touch_active = true;
-        } else {
-            gpio_put(LED_D2, 0);
-            touch_active = false;
-        }
-
-        // Read onboard analog joystick
-        adc_select_input(0);
-        uint16_t joy_x = adc_read();
-        adc_select_input(1);
-        uint16_t joy_y = adc_read();
-
-        // Joystick movement (ADC values are 0-4095, center ~2048)
-        // Dead zone to avoid drift
-        const int16_t dead_zone = 200;
-        const int16_t center = 2048;
-
-        int16_t dx = 0;
-        int16_t dy = 0;
-
-        // Note: X controls vertical, Y controls horizontal (rotated 90 degrees)
-        if (joy_y < center - dead_zone) {
-            dx = ((center - joy_y) / 100);  // Move left
-        } else if (joy_y > center + dead_zone) {
-            dx = -((joy_y - center) / 100);   // Move right
-        }
 
-        if (joy_x < center - dead_zone) {
-            dy = -((center - joy_x) / 100);  // Move up
-        } else if (joy_x > center + dead_zone) {
-            dy = ((joy_x - center) / 100);   // Move down
+            // Batched passes over every entity: move, keep on screen, and
+            // refile for the next step's hit tests
+            entity_integrate(&world, step_us);
+            entity_confine(&world);
+            entity_hash_build(&world);
         }
 
-        // Update position with boundary checking
-        if (dx != 0 || dy != 0) {
-            int16_t new_x = smiley_x + dx;
-            int16_t new_y = smiley_y + dy;
-
-            // Keep smiley sprite on screen
-            if (new_x < 0) new_x = 0;
-            if (new_x > TFT_WIDTH - sprite_size) new_x = TFT_WIDTH - sprite_size;
-            if (new_y < 0) new_y = 0;
-            if (new_y > TFT_HEIGHT - sprite_size) new_y = TFT_HEIGHT - sprite_size;
-
-            smiley_x = new_x;
-            smiley_y = new_y;
-            needs_redraw = true;
+        // ----- Render -----
+        // Hand the new state to core1 if anything changed; if its queue is
+        // full, keep the frame pending and post fresher state next frame
+        if (needs_redraw || frame_pending) {
+            TRACE_ZONE(POST);
+            slot = entity_slot(&world, smiley);
+            frame.x = q16_floor(world.x[slot]);
+            frame.y = q16_floor(world.y[slot]) + hop_y;
+            if (frame.y < 0) frame.y = 0;
+            frame.is_happy = is_happy;
+            frame.face_color = rainbow_colors[color_index];
+            frame_pending = !render_post(&frame);
+            needs_redraw = false;
         }
 
-        // Redraw if anything changed
-        if (needs_redraw) {
-            // Erase old position if moved
-            if (old_x != smiley_x || old_y != smiley_y) {
-                tft_fill_rect(old_x, old_y, sprite_size, sprite_size, COLOR_WHITE);
-            }
-
-            // Redraw sprite to buffer and push to screen
-            draw_smiley_face_to_sprite(smiley_sprite, is_happy, rainbow_colors[color_index]);
-            sprite_push(smiley_sprite, smiley_x, smiley_y);
-
-            old_x = smiley_x;
-            old_y = smiley_y;
-        }
+        // Ship the trace before sleeping, so it costs idle time
+        TRACE_DRAIN();
+        scheduler_end_frame();
     }
 
     return 0;
@@ -0,0 +1,267 @@
+#include "display.h"
+#include "fixed.h"
+#include <stdlib.h>
+
+// Sprite rasterizer. Every primitive is reduced to horizontal spans that
+// are clipped once and filled two pixels per 32-bit store.
+
+// Two RGB565 pixels; may_alias lets it overlay the uint16_t buffer
+typedef uint32_t __attribute__((may_alias)) pixel_pair_t;
+
+static inline void swap16(int16_t *a, int16_t *b) {
+    int16_t t = *a;
+    *a = *b;
+    *b = t;
+}
+
+// ===== SPAN CORE =====
+
+static inline void fill_pixels(uint16_t *p, int32_t n, uint16_t color) {
+    if (n <= 0) return;
+
+    // Align to a word, then store pixel pairs
+    if ((uintptr_t)p & 2) {
+        *p++ = color;
+        n--;
+    }
+    pixel_pair_t pair = color | ((uint32_t)color << 16);
+    pixel_pair_t *w = (pixel_pair_t *)p;
+    for (; n >= 4; n -= 4) {
+        w[0] = pair;
+        w[1] = pair;
+        w += 2;
+    }
+    for (; n >= 2; n -= 2) {
+        *w++ = pair;
+    }
+    if (n) {
+        *(uint16_t *)w = color;
+    }
+}
+
+void sprite_hspan(sprite_t *sprite, int16_t x0, int16_t x1, int16_t y, uint16_t color) {
+    if (y < 0 || y >= sprite->height) return;
+    if (x0 > x1) swap16(&x0, &x1);
+    if (x0 < 0) x0 = 0;
+    if (x1 >= sprite->width) x1 = sprite->width - 1;
+    if (x0 > x1) return;
+
+    fill_pixels(&sprite->buffer[y * sprite->width + x0], x1 - x0 + 1, color);
+}
+
+static inline void blend_pixel(sprite_t *sprite, int16_t x, int16_t y, uint16_t color, uint8_t alpha) {
+    if (x < 0 || x >= sprite->width || y < 0 || y >= sprite->height || alpha == 0) return;
+
+    uint16_t *p = &sprite->buffer[y * sprite->width + x];
+    *p = alpha == 255 ? color : blend565(color, *p, alpha);
+}
+
+// ===== FILLED SHAPES =====
+
+void sprite_fill(sprite_t *sprite, uint16_t color) {
+    fill_pixels(sprite->buffer, (int32_t)sprite->width * sprite->height, color);
+}
+
+void sprite_fill_rect(sprite_t *sprite, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    if (w <= 0 || h <= 0) return;
+
+    int16_t y0 = y < 0 ? 0 : y;
+    int16_t y1 = y + h > sprite->height ? sprite->height : y + h;
+    for (int16_t row = y0; row < y1; row++) {
+        sprite_hspan(sprite, x, x + w - 1, row, color);
+    }
+}
+
+// Rows of a radius-r midpoint circle whose left half is centred on cl
+// and right half on cr, top half on row ct and bottom half on cb (equal
+// for a plain circle; apart for round rect corners). The rows between
+// ct and cb are left to the caller. Spans come out as the midpoint walk
+// finds them, so the pixels are those of the classic per-pixel fill; a
+// few rows near the diagonal are filled twice.
+static void fill_circle_rows(sprite_t *sprite, int16_t cl, int16_t cr, int16_t ct, int16_t cb,
+                             int16_t r, uint16_t color) {
+    int16_t f = 1 - r;
+    int16_t ddF_x = 1;
+    int16_t ddF_y = -2 * r;
+    int16_t x = 0;
+    int16_t y = r;
+
+    while (x < y) {
+        if (f >= 0) {
+            y--;
+            ddF_y += 2;
+            f += ddF_y;
+        }
+        x++;
+        ddF_x += 2;
+        f += ddF_x;
+
+        // Rows x out: one new row per step
+        sprite_hspan(sprite, cl - y, cr + y, ct - x, color);
+        sprite_hspan(sprite, cl - y, cr + y, cb + x, color);
+
+        // Rows y out: widest on the last step before y moves in
+        if (f >= 0 || x >= y) {
+            sprite_hspan(sprite, cl - x, cr + x, ct - y, color);
+            sprite_hspan(sprite, cl - x, cr + x, cb + y, color);
+        }
+    }
+}
+
+void sprite_fill_circle(sprite_t *sprite, int16_t x0, int16_t y0, uint16_t r, uint16_t color) {
+    sprite_hspan(sprite, x0 - r, x0 + r, y0, color);
+    fill_circle_rows(sprite, x0, x0, y0, y0, r, color);
+}
+
+void sprite_fill_round_rect(sprite_t *sprite, int16_t x, int16_t y, int16_t w, int16_t h,
+                            uint16_t r, uint16_t color) {
+    if (w <= 0 || h <= 0) return;
+    if (r > w / 2) r = w / 2;
+    if (r > h / 2) r = h / 2;
+
+    // Straight middle section, then the corner rows above and below it
+    sprite_fill_rect(sprite, x, y + r, w, h - 2 * r, color);
+    fill_circle_rows(sprite, x + r, x + w - 1 - r, y + r, y + h - 1 - r, r, color);
+}
+
+void sprite_fill_triangle(sprite_t *sprite, int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                          int16_t x2, int16_t y2, uint16_t color) {
+    // Sort vertices top to bottom
+    if (y0 > y1) { swap16(&y0, &y1); swap16(&x0, &x1); }
+    if (y1 > y2) { swap16(&y1, &y2); swap16(&x1, &x2); }
+    if (y0 > y1) { swap16(&y0, &y1); swap16(&x0, &x1); }
+
+    if (y0 == y2) {
+        int16_t a = x0, b = x0;
+        if (x1 < a) a = x1; else if (x1 > b) b = x1;
+        if (x2 < a) a = x2; else if (x2 > b) b = x2;
+        sprite_hspan(sprite, a, b, y0, color);
+        return;
+    }
+
+    // Walk the long edge (0-2) against the short edges (0-1, then 1-2),
+    // x positions in 16.16
+    int32_t step_a = ((int32_t)(x2 - x0) << 16) / (y2 - y0);
+    int32_t xa = (int32_t)x0 << 16;
+    int32_t step_b = y1 > y0 ? ((int32_t)(x1 - x0) << 16) / (y1 - y0) : 0;
+    int32_t xb = (int32_t)x0 << 16;
+
+    for (int16_t y = y0; y <= y2; y++) {
+        if (y == y1) {
+            step_b = y2 > y1 ? ((int32_t)(x2 - x1) << 16) / (y2 - y1) : 0;
+            xb = (int32_t)x1 << 16;
+        }
+
+        sprite_hspan(sprite, (xa + 0x8000) >> 16, (xb + 0x8000) >> 16, y, color);
+        xa += step_a;
+        xb += step_b;
+    }
+}
+
+// ===== LINES =====
+
+void sprite_draw_line(sprite_t *sprite, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+    // Mostly-horizontal lines are emitted as one span per row
+    if (abs(x1 - x0) >= abs(y1 - y0)) {
+        if (x0 > x1) { swap16(&x0, &x1); swap16(&y0, &y1); }
+
+        int16_t dx = x1 - x0;
+        int16_t dy = abs(y1 - y0);
+        int16_t ystep = y0 < y1 ? 1 : -1;
+        int16_t err = dx / 2;
+        int16_t run_start = x0;
+
+        for (int16_t x = x0; x <= x1; x++) {
+            err -= dy;
+            if (err < 0 || x == x1) {
+                sprite_hspan(sprite, run_start, x, y0, color);
+                run_start = x + 1;
+                y0 += ystep;
+                err += dx;
+            }
+        }
+        return;
+    }
+
+    // Steep lines have one pixel per row
+    if (y0 > y1) { swap16(&x0, &x1); swap16(&y0, &y1); }
+
+    int16_t dx = abs(x1 - x0);
+    int16_t dy = y1 - y0;
+    int16_t xstep = x0 < x1 ? 1 : -1;
+    int16_t err = dy / 2;
+
+    for (int16_t y = y0; y <= y1; y++) {
+        if (x0 >= 0 && x0 < sprite->width && y >= 0 && y < sprite->height) {
+            sprite->buffer[y * sprite->width + x0] = color;
+        }
+        err -= dx;
+        if (err < 0) {
+            x0 += xstep;
+            err += dy;
+        }
+    }
+}
+
+// ===== ANTI-ALIASED VARIANTS =====
+
+void sprite_fill_circle_aa(sprite_t *sprite, int16_t x0, int16_t y0, uint16_t r, uint16_t color) {
+    const int32_t rr = r;
+
+    for (int16_t dy = -(int16_t)r; dy <= (int16_t)r; dy++) {
+        int32_t dy2 = (int32_t)dy * dy;
+
+        // Pixels within r - 0.5 are fully covered
+        int32_t inner2 = rr * rr - rr - dy2;
+        int16_t inner = inner2 >= 0 ? (int16_t)isqrt32((uint32_t)inner2) : -1;
+        int16_t outer = (int16_t)isqrt32((uint32_t)(rr * rr + rr - dy2)) + 1;
+
+        if (inner >= 0) {
+            sprite_hspan(sprite, x0 - inner, x0 + inner, y0 + dy, color);
+        }
+
+        // Edge band: coverage = r + 0.5 - distance, distances in 1/16 px
+        for (int16_t dx = inner + 1; dx <= outer; dx++) {
+            int32_t d16 = (int32_t)isqrt32((uint32_t)((dx * dx + dy2) << 8));
+            int32_t a = (rr * 16 + 8 - d16) * 16;
+            if (a <= 0) continue;
+            if (a > 255) a = 255;
+
+            blend_pixel(sprite, x0 + dx, y0 + dy, color, (uint8_t)a);
+            if (dx != 0) {
+                blend_pixel(sprite, x0 - dx, y0 + dy, color, (uint8_t)a);
+            }
+        }
+    }
+}
+
+// Xiaolin Wu's line, 16.16 fixed point
+void sprite_draw_line_aa(sprite_t *sprite, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+    bool steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep) {
+        swap16(&x0, &y0);
+        swap16(&x1, &y1);
+    }
+    if (x0 > x1) {
+        swap16(&x0, &x1);
+        swap16(&y0, &y1);
+    }
+
+    int16_t dx = x1 - x0;
+    int32_t gradient = dx ? ((int32_t)(y1 - y0) << 16) / dx : 0;
+    int32_t y = (int32_t)y0 << 16;
+
+    for (int16_t x = x0; x <= x1; x++) {
+        int16_t yi = y >> 16;
+        uint8_t frac = (y >> 8) & 0xFF;
+
+        if (steep) {
+            blend_pixel(sprite, yi, x, color, 255 - frac);
+            blend_pixel(sprite, yi + 1, x, color, frac);
+        } else {
+            blend_pixel(sprite, x, yi, color, 255 - frac);
+            blend_pixel(sprite, x, yi + 1, color, frac);
+        }
+        y += gradient;
+    }
+}
@@ -0,0 +1,135 @@
+#include "render.h"
+#include "compositor.h"
+#include "spsc.h"
+#include "trace.h"
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "hardware/sync.h"
+
+#ifdef RENDER_HUD
+#include "assets.h"
+#include <stdio.h>
+#endif
+
+#define RENDER_QUEUE_LEN 4
+
+// A frame as queued, stamped so core1 can report latency
+typedef struct {
+    frame_desc_t frame;
+    uint64_t posted_us;
+} render_item_t;
+
+static render_item_t queue_storage[RENDER_QUEUE_LEN];
+static spsc_t frame_queue;
+
+static compositor_t comp;
+static render_draw_fn draw_frame;
+static volatile render_stats_t stats;
+
+// ===== HUD =====
+
+#ifdef RENDER_HUD
+#define HUD_FONT        asset_mono12
+#define HUD_PERIOD_US   500000
+
+static text_run_t hud;
+static uint64_t hud_since;
+static uint32_t hud_frames;
+
+static void hud_init(void) {
+    uint16_t y = TFT_HEIGHT - RENDER_HUD_HEIGHT + (RENDER_HUD_HEIGHT - HUD_FONT.line_height) / 2;
+    text_run_init(&hud, &HUD_FONT, 4, y, COLOR_BLACK, comp.background);
+    hud_since = time_us_64();
+}
+
+// Refreshed twice a second from the last frame's numbers; the text run
+// only re-sends the characters that changed
+static void hud_update(uint64_t now) {
+    hud_frames++;
+    if (now - hud_since < HUD_PERIOD_US) return;
+
+    uint32_t fps10 = (uint32_t)((uint64_t)hud_frames * 10000000 / (now - hud_since));
+    char line[80]; // text_run_set() truncates
+    snprintf(line, sizeof(line), "%2lu.%lu fps  draw %4lu  send %4lu  lat %5luus",
+             (unsigned long)(fps10 / 10), (unsigned long)(fps10 % 10),
+             (unsigned long)stats.draw_us, (unsigned long)stats.present_us,
+             (unsigned long)stats.latency_us);
+    text_run_set(&hud, line);
+
+    hud_since = now;
+    hud_frames = 0;
+}
+#endif
+
+// ===== CORE1 =====
+
+static void render_core1_main(void) {
+    render_item_t item;
+
+#ifdef RENDER_HUD
+    hud_init();
+#endif
+
+    while (true) {
+        if (!spsc_pop(&frame_queue, &item)) {
+            TRACE_BEGIN(RENDER_WAIT);
+            __wfe();
+            TRACE_END(RENDER_WAIT);
+            continue;
+        }
+
+        // Skip straight to the newest frame if core0 got ahead of us
+        while (spsc_pop(&frame_queue, &item)) {
+        }
+        arena_frame_reset();
+
+        uint64_t t0 = time_us_64();
+        TRACE_BEGIN(RENDER_DRAW);
+        draw_frame(comp.back, &item.frame);
+        TRACE_END(RENDER_DRAW);
+        uint64_t t1 = time_us_64();
+        TRACE_BEGIN(RENDER_PRESENT);
+        compositor_present(&comp, item.frame.x, item.frame.y);
+        TRACE_END(RENDER_PRESENT);
+        uint64_t t2 = time_us_64();
+
+        stats.draw_us = (uint32_t)(t1 - t0);
+        stats.present_us = (uint32_t)(t2 - t1);
+        stats.latency_us = (uint32_t)(t2 - item.posted_us);
+        stats.pixels_pushed = compositor_stats(&comp)->pixels_pushed;
+        stats.frames_drawn++;
+
+#ifdef RENDER_HUD
+        hud_update(t2);
+#endif
+    }
+}
+
+// ===== CORE0 API =====
+
+bool render_init(uint16_t width, uint16_t height, uint16_t background, render_draw_fn draw) {
+    if (!compositor_init(&comp, width, height, background)) {
+        return false;
+    }
+
+    draw_frame = draw;
+    spsc_init(&frame_queue, queue_storage, sizeof(render_item_t), RENDER_QUEUE_LEN);
+    multicore_launch_core1(render_core1_main);
+    return true;
+}
+
+bool render_post(const frame_desc_t *frame) {
+    render_item_t item = {*frame, time_us_64()};
+    if (!spsc_push(&frame_queue, &item)) {
+        stats.frames_dropped++;
+        return false;
+    }
+
+    stats.frames_posted++;
+    __sev(); // Wake core1 if it is waiting for work
+    return true;
+}
+
+const volatile render_stats_t* render_stats(void) {
+    return &stats;
+}
@@ -0,0 +1,49 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "display.h"
+
+// What core0 wants on screen; core1 turns it into pixels
+typedef struct {
+    int16_t x;                // Panel position of the sprite
+    int16_t y;
+    bool is_happy;
+    uint16_t face_color;
+} frame_desc_t;
+
+// Rasterizes one frame into the sprite (runs on core1)
+typedef void (*render_draw_fn)(sprite_t *sprite, const frame_desc_t *frame);
+
+typedef struct {
+    uint32_t frames_posted;   // Accepted by render_post
+    uint32_t frames_drawn;    // Rasterized and sent by core1
+    uint32_t frames_dropped;  // Rejected because the queue was full
+    uint32_t draw_us;         // Raster time of the last frame
+    uint32_t present_us;      // Transfer time of the last frame
+    uint32_t pixels_pushed;   // Pixels sent for the last frame
+    uint32_t latency_us;      // From render_post to on the panel, last frame
+} render_stats_t;
+
+// Optional frame rate and timing overlay (-DLIL_GUY_HUD=ON), drawn by
+// core1 in a strip along the bottom of the panel. The sprite must stay
+// out of that strip.
+#ifdef RENDER_HUD
+#define RENDER_HUD_HEIGHT 16
+#else
+#define RENDER_HUD_HEIGHT 0
+#endif
+
+// Allocate the sprite buffers and start the render loop on core1.
+// The display must already be initialized; from here on only core1
+// may touch it.
+bool render_init(uint16_t width, uint16_t height, uint16_t background, render_draw_fn draw);
+
+// Queue a frame for core1 (core0 only). Returns false if the queue is
+// full, in which case the caller should retry with newer state later.
+bool render_post(const frame_desc_t *frame);
+
+const volatile render_stats_t* render_stats(void);
+
+#endif // RENDER_H
@@ -0,0 +1,130 @@
+#include "scheduler.h"
+#include "pico/cyw43_arch.h"
+#include "trace.h"
+#include "arena.h"
+
+static uint32_t step_us;
+static uint32_t frame_us;
+
+static uint64_t last_time;      // When the accumulator was last advanced
+static uint64_t accumulator;    // Simulation time owed, in us
+static uint64_t next_frame;     // Deadline of the current frame
+static uint64_t frame_start;
+static uint64_t update_end;
+static bool updates_done;
+
+static scheduler_stats_t stats;
+
+void scheduler_init(uint16_t update_hz, uint16_t frame_hz) {
+    step_us = 1000000 / update_hz;
+    frame_us = 1000000 / frame_hz;
+
+    last_time = time_us_64();
+    next_frame = last_time + frame_us;
+    accumulator = 0;
+}
+
+void scheduler_set_frame_rate(uint16_t frame_hz) {
+    frame_us = 1000000 / frame_hz;
+}
+
+void scheduler_begin_frame(void) {
+    uint64_t now = time_us_64();
+    accumulator += now - last_time;
+    last_time = now;
+
+    frame_start = now;
+    stats.steps = 0;
+    updates_done = false;
+
+    // Core0's frame scratch starts empty every frame
+    arena_frame_reset();
+}
+
+bool scheduler_update_due(void) {
+    if (updates_done) return false;
+
+    if (accumulator >= step_us && stats.steps < SCHEDULER_MAX_STEPS) {
+        accumulator -= step_us;
+        stats.steps++;
+        return true;
+    }
+
+    // Still behind after the catch-up budget: drop the backlog rather than
+    // spiral further behind
+    if (accumulator >= step_us) {
+        stats.dropped_steps += accumulator / step_us;
+        accumulator %= step_us;
+    }
+
+    update_end = time_us_64();
+    updates_done = true;
+    return false;
+}
+
+void scheduler_end_frame(void) {
+    if (!updates_done) {
+        update_end = frame_start;
+    }
+
+    uint64_t now = time_us_64();
+    stats.update_us = (uint32_t)(update_end - frame_start);
+    stats.render_us = (uint32_t)(now - update_end);
+    stats.frames++;
+
+    // Overran: count the frame slots already missed and realign to the
+    // next one instead of trying to catch up
+    if (now >= next_frame) {
+        uint64_t missed = (now - next_frame) / frame_us + 1;
+        stats.dropped_frames += missed;
+        stats.slack_us = -(int32_t)(now - next_frame);
+        next_frame += missed * frame_us;
+    } else {
+        stats.slack_us = (int32_t)(next_frame - now);
+    }
+
+    TRACE_BEGIN(SLEEP);
+    sleep_until(from_us_since_boot(next_frame));
+    TRACE_END(SLEEP);
+    next_frame += frame_us;
+}
+
+uint32_t scheduler_step_us(void) {
+    return step_us;
+}
+
+const scheduler_stats_t* scheduler_stats(void) {
+    return &stats;
+}
+
+// ===== HEARTBEAT =====
+
+static repeating_timer_t heartbeat_timer;
+static async_at_time_worker_t heartbeat_wl_worker;
+static uint32_t heartbeat_half_ms;
+static bool heartbeat_wl_on;
+
+static bool heartbeat_gpio_tick(repeating_timer_t *rt) {
+    uint gpio = (uint)(uintptr_t)rt->user_data;
+    gpio_put(gpio, !gpio_get(gpio));
+    return true;
+}
+
+// The CYW43 LED sits behind the WiFi chip's bus, which may not be touched
+// from a raw alarm IRQ, so it blinks from an async_context worker instead
+static void heartbeat_wl_tick(async_context_t *context, async_at_time_worker_t *worker) {
+    heartbeat_wl_on = !heartbeat_wl_on;
+    cyw43_arch_gpio_put(CYW43_WL_GPIO_LED_PIN, heartbeat_wl_on);
+    async_context_add_at_time_worker_in_ms(context, worker, heartbeat_half_ms);
+}
+
+void scheduler_heartbeat_start(uint gpio, uint32_t half_period_ms) {
+    heartbeat_half_ms = half_period_ms;
+
+    add_repeating_timer_ms(-(int32_t)half_period_ms, heartbeat_gpio_tick,
+                           (void *)(uintptr_t)gpio, &heartbeat_timer);
+
+    heartbeat_wl_worker.do_work = heartbeat_wl_tick;
+    async_context_add_at_time_worker_in_ms(cyw43_arch_async_context(),
+                                           &heartbeat_wl_worker, half_period_ms);
+}
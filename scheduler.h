@@ -0,0 +1,42 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/stdlib.h"
+
+// Game state advances in fixed steps of 1/update_hz seconds; rendering
+// happens once per frame at frame_hz. When a frame overruns, missed
+// frames are skipped and at most SCHEDULER_MAX_STEPS updates are run to
+// catch up, the rest of the backlog being dropped.
+#define SCHEDULER_MAX_STEPS 5
+
+typedef struct {
+    uint32_t update_us;       // Time spent in update steps last frame
+    uint32_t render_us;       // Time spent rendering last frame
+    int32_t slack_us;         // Idle time before the next frame (negative on overrun)
+    uint8_t steps;            // Update steps run last frame
+    uint32_t frames;          // Frames completed
+    uint32_t dropped_frames;  // Frame slots skipped under overload
+    uint32_t dropped_steps;   // Update steps discarded under overload
+} scheduler_stats_t;
+
+void scheduler_init(uint16_t update_hz, uint16_t frame_hz);
+void scheduler_set_frame_rate(uint16_t frame_hz);
+
+// Frame loop:
+//     scheduler_begin_frame();
+//     while (scheduler_update_due()) { ...fixed step... }
+//     ...render...
+//     scheduler_end_frame();
+void scheduler_begin_frame(void);
+bool scheduler_update_due(void);
+void scheduler_end_frame(void);
+
+uint32_t scheduler_step_us(void);
+const scheduler_stats_t* scheduler_stats(void);
+
+// Blink `gpio` and the CYW43 LED from timers, `half_period_ms` on and off
+void scheduler_heartbeat_start(uint gpio, uint32_t half_period_ms);
+
+#endif // SCHEDULER_H
@@ -0,0 +1,172 @@
+#include "display.h"
+#include <string.h>
+
+// Pixels expanded per DMA run; one chunk is filled while the other is sent
+#define EXPAND_CHUNK    256
+
+// Read position within an indexed sprite, in raster order
+typedef struct {
+    const indexed_sprite_t *sprite;
+    uint16_t row;             // Packed formats
+    uint16_t col;
+    const uint8_t *rle;       // SPRITE_RLE8
+    uint8_t run;              // Pixels left in the current run
+    bool repeat;
+    uint8_t value;
+} expand_cursor_t;
+
+static inline uint8_t format_bpp(uint8_t format) {
+    return 1u << format; // SPRITE_INDEX1..SPRITE_INDEX8
+}
+
+uint32_t indexed_sprite_size(uint8_t format, uint16_t width, uint16_t height) {
+    if (format > SPRITE_INDEX8) return 0;
+    return ((uint32_t)width * format_bpp(format) + 7) / 8 * height;
+}
+
+static void cursor_init(expand_cursor_t *c, const indexed_sprite_t *sprite) {
+    memset(c, 0, sizeof(*c));
+    c->sprite = sprite;
+    c->rle = sprite->data;
+}
+
+// n pixels of one packed row starting at col
+static void expand_row(const indexed_sprite_t *s, uint16_t row, uint16_t col,
+                       uint16_t n, uint16_t *dst) {
+    const uint16_t *pal = s->palette;
+    uint8_t bpp = format_bpp(s->format);
+    uint32_t stride = ((uint32_t)s->width * bpp + 7) / 8;
+    const uint8_t *src = s->data + row * stride;
+
+    if (bpp == 8) {
+        src += col;
+        for (uint16_t i = 0; i < n; i++) {
+            dst[i] = pal[src[i]];
+        }
+        return;
+    }
+
+    // Walk the bits of each byte from the top, loading only bytes that
+    // are actually used so the last row never reads past the data
+    uint8_t mask = (1u << bpp) - 1;
+    uint32_t bit = (uint32_t)col * bpp;
+    src += bit / 8;
+    int8_t shift = 8 - bpp - (bit % 8);
+    uint8_t byte = *src++;
+
+    for (uint16_t i = 0; i < n; i++) {
+        if (shift < 0) {
+            byte = *src++;
+            shift = 8 - bpp;
+        }
+        dst[i] = pal[(byte >> shift) & mask];
+        shift -= bpp;
+    }
+}
+
+// Decode the next n pixels in raster order
+static void expand(expand_cursor_t *c, uint16_t *dst, uint32_t n) {
+    const indexed_sprite_t *s = c->sprite;
+
+    if (s->format == SPRITE_RLE8) {
+        const uint16_t *pal = s->palette;
+        while (n > 0) {
+            if (c->run == 0) {
+                uint8_t ctl = *c->rle++;
+                c->repeat = ctl & 0x80;
+                c->run = (ctl & 0x7F) + 1;
+                if (c->repeat) c->value = *c->rle++;
+            }
+
+            uint8_t k = c->run < n ? c->run : n;
+            if (c->repeat) {
+                uint16_t color = pal[c->value];
+                for (uint8_t i = 0; i < k; i++) dst[i] = color;
+            } else {
+                for (uint8_t i = 0; i < k; i++) dst[i] = pal[*c->rle++];
+            }
+            c->run -= k;
+            dst += k;
+            n -= k;
+        }
+        return;
+    }
+
+    while (n > 0) {
+        uint16_t k = s->width - c->col;
+        if (k > n) k = n;
+
+        expand_row(s, c->row, c->col, k, dst);
+        dst += k;
+        n -= k;
+        c->col += k;
+        if (c->col == s->width) {
+            c->col = 0;
+            c->row++;
+        }
+    }
+}
+
+void indexed_sprite_push(const indexed_sprite_t *sprite, uint16_t x, uint16_t y) {
+    expand_cursor_t c;
+    cursor_init(&c, sprite);
+
+    // The window makes the pixel stream continuous, so chunks ignore rows
+    uint32_t left = (uint32_t)sprite->width * sprite->height;
+    uint8_t buf = 0;
+
+    arena_t *scratch = arena_frame();
+    arena_mark_t mark = arena_mark(scratch);
+    uint16_t *chunks = arena_alloc(scratch, 2 * EXPAND_CHUNK * sizeof(uint16_t), ARENA_ALIGN);
+    if (!chunks) return;
+
+    tft_write_begin(x, y, sprite->width, sprite->height);
+    while (left > 0) {
+        uint32_t n = left < EXPAND_CHUNK ? left : EXPAND_CHUNK;
+
+        // Returns once the previous chunk, in the other buffer, is done
+        uint16_t *chunk = &chunks[buf * EXPAND_CHUNK];
+        expand(&c, chunk, n);
+        tft_write_pixels(chunk, n);
+        buf ^= 1;
+        left -= n;
+    }
+    tft_write_end();
+
+    arena_release(scratch, mark);
+}
+
+void indexed_sprite_draw(const indexed_sprite_t *sprite, sprite_t *dst, int16_t x, int16_t y) {
+    expand_cursor_t c;
+    cursor_init(&c, sprite);
+
+    arena_t *scratch = arena_frame();
+    arena_mark_t mark = arena_mark(scratch);
+    uint16_t *chunk = arena_alloc(scratch, EXPAND_CHUNK * sizeof(uint16_t), ARENA_ALIGN);
+    if (!chunk) return;
+
+    for (uint16_t row = 0; row < sprite->height; row++) {
+        int16_t dy = y + row;
+        if (dy >= dst->height) break;
+
+        // RLE has to be decoded in order even above the sprite; packed
+        // rows could be skipped, but the cursor keeps one code path
+        for (uint16_t col = 0; col < sprite->width; col += EXPAND_CHUNK) {
+            uint16_t n = sprite->width - col;
+            if (n > EXPAND_CHUNK) n = EXPAND_CHUNK;
+            expand(&c, chunk, n);
+            if (dy < 0) continue;
+
+            int16_t x0 = x + col;
+            int16_t x1 = x0 + n;
+            int16_t skip = x0 < 0 ? -x0 : 0;
+            if (x1 > dst->width) x1 = dst->width;
+            if (x0 + skip >= x1) continue;
+
+            memcpy(&dst->buffer[dy * dst->width + x0 + skip], &chunk[skip],
+                   (x1 - x0 - skip) * sizeof(uint16_t));
+        }
+    }
+
+    arena_release(scratch, mark);
+}
@@ -0,0 +1,53 @@
+#ifndef SPSC_H
+#define SPSC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <string.h>
+
+// Lock-free single-producer/single-consumer ring of fixed-size elements.
+// Safe between the two cores, or between an IRQ and thread code, as long
+// as each side only ever has one writer. Capacity must be a power of two.
+typedef struct {
+    uint8_t *storage;
+    uint16_t elem_size;
+    uint16_t mask;
+    atomic_uint head;         // Next slot to write (producer owned)
+    atomic_uint tail;         // Next slot to read (consumer owned)
+} spsc_t;
+
+static inline void spsc_init(spsc_t *q, void *storage, uint16_t elem_size, uint16_t capacity) {
+    q->storage = storage;
+    q->elem_size = elem_size;
+    q->mask = capacity - 1;
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+}
+
+static inline bool spsc_push(spsc_t *q, const void *elem) {
+    unsigned head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+    if (head - tail > q->mask) return false;
+
+    memcpy(q->storage + (head & q->mask) * q->elem_size, elem, q->elem_size);
+    atomic_store_explicit(&q->head, head + 1, memory_order_release);
+    return true;
+}
+
+static inline bool spsc_pop(spsc_t *q, void *elem) {
+    unsigned tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&q->head, memory_order_acquire);
+    if (head == tail) return false;
+
+    memcpy(elem, q->storage + (tail & q->mask) * q->elem_size, q->elem_size);
+    atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+static inline bool spsc_empty(spsc_t *q) {
+    return atomic_load_explicit(&q->head, memory_order_acquire) ==
+           atomic_load_explicit(&q->tail, memory_order_relaxed);
+}
+
+#endif // SPSC_H
@@ -0,0 +1,185 @@
+#include "display.h"
+#include <string.h>
+
+const font_glyph_t* font_glyph(const font_t *font, uint8_t code) {
+    for (uint8_t i = 0; i < font->range_count; i++) {
+        const font_range_t *r = &font->ranges[i];
+        if (code >= r->first && code - r->first < r->count) {
+            return &font->glyphs[r->glyph + code - r->first];
+        }
+    }
+    return code == '?' ? NULL : font_glyph(font, '?');
+}
+
+uint16_t text_width(const font_t *font, const char *text) {
+    uint16_t w = 0;
+    for (; *text; text++) {
+        const font_glyph_t *g = font_glyph(font, (uint8_t)*text);
+        if (g) w += g->advance;
+    }
+    return w;
+}
+
+// Like text_width, but also covering glyphs that overhang their advance
+static uint16_t text_extent(const font_t *font, const char *text) {
+    int16_t pen = 0;
+    int16_t right = 0;
+    for (; *text; text++) {
+        const font_glyph_t *g = font_glyph(font, (uint8_t)*text);
+        if (!g) continue;
+        if (g->width && pen + g->x_offset + g->width > right) right = pen + g->x_offset + g->width;
+        pen += g->advance;
+    }
+    return right > pen ? right : pen;
+}
+
+// Coverage level of pixel gx in a glyph bitmap row
+static inline uint8_t glyph_level(const uint8_t *row, uint8_t gx) {
+    uint8_t b = row[gx >> 1];
+    return gx & 1 ? b & 0x0F : b >> 4;
+}
+
+void sprite_draw_text(sprite_t *sprite, const font_t *font, int16_t x, int16_t y,
+                      const char *text, uint16_t color) {
+    int16_t pen = x;
+
+    for (; *text; text++) {
+        const font_glyph_t *g = font_glyph(font, (uint8_t)*text);
+        if (!g) continue;
+
+        const uint8_t *bits = font->bitmap + g->offset;
+        uint8_t stride = (g->width + 1) / 2;
+        int16_t gx0 = pen + g->x_offset;
+        int16_t gy0 = y + font->ascent + g->y_offset;
+
+        for (uint8_t gy = 0; gy < g->height; gy++) {
+            int16_t py = gy0 + gy;
+            if (py < 0) continue;
+            if (py >= sprite->height) break;
+
+            const uint8_t *row = bits + gy * stride;
+            uint16_t *dst = &sprite->buffer[py * sprite->width];
+            for (uint8_t gx = 0; gx < g->width; gx++) {
+                int16_t px = gx0 + gx;
+                if (px < 0 || px >= sprite->width) continue;
+
+                uint8_t level = glyph_level(row, gx);
+                if (level == 15) {
+                    dst[px] = color;
+                } else if (level) {
+                    dst[px] = blend565(color, dst[px], level * 17);
+                }
+            }
+        }
+        pen += g->advance;
+    }
+}
+
+uint16_t tft_draw_text(uint16_t x, uint16_t y, const font_t *font, const char *text,
+                       uint16_t fg, uint16_t bg) {
+    if (x >= TFT_WIDTH || y >= TFT_HEIGHT) return 0;
+
+    uint16_t w = text_extent(font, text);
+    uint16_t h = font->line_height;
+    if (w > TFT_WIDTH - x) w = TFT_WIDTH - x;
+    if (h > TFT_HEIGHT - y) h = TFT_HEIGHT - y;
+    if (w == 0 || h == 0) return 0;
+
+    // Rows being streamed to the panel (one filling, one in flight)
+    arena_t *scratch = arena_frame();
+    arena_mark_t mark = arena_mark(scratch);
+    uint16_t *rows = arena_alloc(scratch, 2 * w * sizeof(uint16_t), ARENA_ALIGN);
+    if (!rows) return 0;
+
+    // Every pixel is one of 16 blends of fg over bg; work them out once
+    uint16_t shade[16];
+    for (uint8_t i = 0; i < 16; i++) {
+        shade[i] = blend565(fg, bg, i * 17);
+    }
+
+    tft_write_begin(x, y, w, h);
+    for (uint16_t line = 0; line < h; line++) {
+        // Returned from tft_write_pixels two rows ago, so it is free
+        uint16_t *buf = &rows[(line & 1) * w];
+        for (uint16_t i = 0; i < w; i++) buf[i] = bg;
+
+        int16_t pen = 0;
+        for (const char *c = text; *c && pen < w; c++) {
+            const font_glyph_t *g = font_glyph(font, (uint8_t)*c);
+            if (!g) continue;
+
+            int16_t gy = line - font->ascent - g->y_offset;
+            if (gy >= 0 && gy < g->height) {
+                const uint8_t *row = font->bitmap + g->offset + gy * ((g->width + 1) / 2);
+                int16_t gx0 = pen + g->x_offset;
+                for (uint8_t gx = 0; gx < g->width; gx++) {
+                    int16_t px = gx0 + gx;
+                    uint8_t level = glyph_level(row, gx);
+                    if (level && px >= 0 && px < w) buf[px] = shade[level];
+                }
+            }
+            pen += g->advance;
+        }
+        tft_write_pixels(buf, w);
+    }
+    tft_write_end();
+
+    arena_release(scratch, mark);
+    return w;
+}
+
+// ===== TEXT RUNS =====
+
+void text_run_init(text_run_t *run, const font_t *font, uint16_t x, uint16_t y,
+                   uint16_t fg, uint16_t bg) {
+    memset(run, 0, sizeof(*run));
+    run->font = font;
+    run->x = x;
+    run->y = y;
+    run->fg = fg;
+    run->bg = bg;
+}
+
+void text_run_set(text_run_t *run, const char *text) {
+    if (run->x >= TFT_WIDTH || run->y >= TFT_HEIGHT) return;
+
+    char next[TEXT_RUN_MAX + 1];
+    strncpy(next, text, TEXT_RUN_MAX);
+    next[TEXT_RUN_MAX] = '\0';
+
+    // Glyphs before the first difference are already on the panel. Start
+    // one glyph early in case the changed one overhangs its neighbour.
+    size_t same = 0;
+    if (run->drawn) {
+        if (strcmp(run->text, next) == 0) return;
+        while (run->text[same] == next[same]) same++;
+        if (same > 0) same--;
+    }
+
+    char prefix[TEXT_RUN_MAX + 1];
+    memcpy(prefix, next, same);
+    prefix[same] = '\0';
+    uint16_t pen = text_width(run->font, prefix);
+
+    uint16_t width = pen;
+    if (run->x + pen < TFT_WIDTH) {
+        width += tft_draw_text(run->x + pen, run->y, run->font, next + same, run->fg, run->bg);
+    }
+
+    // Clear whatever the old, longer text left behind
+    if (run->width > width && run->x + width < TFT_WIDTH) {
+        uint16_t clear = run->width - width;
+        if (clear > TFT_WIDTH - run->x - width) clear = TFT_WIDTH - run->x - width;
+        uint16_t h = run->font->line_height;
+        if (h > TFT_HEIGHT - run->y) h = TFT_HEIGHT - run->y;
+        tft_fill_rect(run->x + width, run->y, clear, h, run->bg);
+    }
+
+    memcpy(run->text, next, sizeof(next));
+    run->width = width;
+    run->drawn = true;
+}
+
+void text_run_invalidate(text_run_t *run) {
+    run->drawn = false;
+}
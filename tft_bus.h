@@ -0,0 +1,41 @@
+#ifndef TFT_BUS_H
+#define TFT_BUS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Write-only link to the ST7796, implemented either by the SPI block
+// (tft_spi.c) or by a PIO state machine (tft_pio.c); CMake picks one.
+// Both send native RGB565 pixels MSB first, so sprites need no swapping.
+
+// Display pins shared by both transports
+#define TFT_CLK         2
+#define TFT_MOSI        3
+#define TFT_CS          5
+#define TFT_DC          6
+
+// Name of the compiled-in transport, for diagnostics
+extern const char *const tft_bus_name;
+
+// Claim the peripheral, pins and DMA channel
+void tft_bus_init(void);
+
+// Command byte (D/C low) and parameter bytes (D/C high). Only valid while
+// no pixel DMA is running.
+void tft_bus_command(uint8_t cmd);
+void tft_bus_data(const uint8_t *data, uint32_t len);
+
+// Queued command stream: records of a command byte, a little-endian 16-bit
+// parameter count and that many parameter bytes, sent as one transaction.
+// Same rules as tft_bus_command().
+void tft_bus_batch(const uint8_t *buf, uint32_t len);
+
+// Pixel data phase: begin, any number of DMA runs, end. A run may only
+// start once the previous one's DMA has finished.
+void tft_bus_pixels_begin(void);
+void tft_bus_pixels(const uint16_t *src, uint32_t count, bool increment);
+bool tft_bus_pixels_busy(void);
+void tft_bus_pixels_wait(void);
+void tft_bus_pixels_end(void);
+
+#endif // TFT_BUS_H
@@ -0,0 +1,102 @@
+#include "tft_bus.h"
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "hardware/dma.h"
+#include "hardware/clocks.h"
+#include "tft_pio.pio.h"
+
+// PIO transport: one state machine clocks the bits and drives CS and D/C
+// itself, so the CPU only queues words. The SPI block tops out at an even
+// divisor of clk_peri (37.5 MHz at 150 MHz), while PIO can hit the target
+// clock directly.
+#define TFT_PIO         pio0
+#define TFT_PIO_BAUD    (62500 * 1000) // 62.5 MHz
+
+_Static_assert(TFT_DC == TFT_CS + 1, "tft_pio.pio sets CS and D/C as adjacent pins");
+
+const char *const tft_bus_name = "PIO";
+
+static uint tft_sm;
+static int tft_dma_chan = -1;
+
+static inline void tft_pio_put(uint32_t word) {
+    pio_sm_put_blocking(TFT_PIO, tft_sm, word);
+}
+
+static inline void tft_pio_header(bool dc, uint32_t bits) {
+    tft_pio_put(((uint32_t)dc << 31) | (bits - 1));
+}
+
+void tft_bus_init(void) {
+    uint offset = pio_add_program(TFT_PIO, &tft_pio_program);
+    tft_sm = pio_claim_unused_sm(TFT_PIO, true);
+
+    float clk_div = (float)clock_get_hz(clk_sys) / (2.0f * TFT_PIO_BAUD);
+    if (clk_div < 1.0f) clk_div = 1.0f;
+    tft_pio_program_init(TFT_PIO, tft_sm, offset, TFT_CLK, TFT_MOSI, TFT_CS, clk_div);
+
+    // DMA channel for pixel data
+    tft_dma_chan = dma_claim_unused_channel(true);
+}
+
+void tft_bus_command(uint8_t cmd) {
+    tft_pio_header(false, 8);
+    tft_pio_put((uint32_t)cmd << 24);
+}
+
+// Bytes are packed two per word into the top half, the part the state
+// machine shifts out before autopulling again
+void tft_bus_data(const uint8_t *data, uint32_t len) {
+    if (len == 0) return;
+
+    tft_pio_header(true, len * 8);
+    for (uint32_t i = 0; i < len; i += 2) {
+        uint32_t word = (uint32_t)data[i] << 24;
+        if (i + 1 < len) word |= (uint32_t)data[i + 1] << 16;
+        tft_pio_put(word);
+    }
+}
+
+// The state machine frames each header itself, so a batch is just its
+// records queued back to back; the CPU never waits on CS
+void tft_bus_batch(const uint8_t *buf, uint32_t len) {
+    const uint8_t *end = buf + len;
+
+    while (buf < end) {
+        uint16_t count = buf[1] | (buf[2] << 8);
+
+        tft_bus_command(buf[0]);
+        tft_bus_data(buf + 3, count);
+        buf += 3 + count;
+    }
+}
+
+void tft_bus_pixels_begin(void) {
+    // Each run carries its own header; nothing to set up
+}
+
+void tft_bus_pixels(const uint16_t *src, uint32_t count, bool increment) {
+    if (count == 0) return;
+    tft_pio_header(true, count * 16);
+
+    dma_channel_config c = dma_channel_get_default_config(tft_dma_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, increment);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, pio_get_dreq(TFT_PIO, tft_sm, true));
+
+    dma_channel_configure(tft_dma_chan, &c, &TFT_PIO->txf[tft_sm], src, count, true);
+}
+
+bool tft_bus_pixels_busy(void) {
+    return dma_channel_is_busy(tft_dma_chan);
+}
+
+void tft_bus_pixels_wait(void) {
+    dma_channel_wait_for_finish_blocking(tft_dma_chan);
+}
+
+void tft_bus_pixels_end(void) {
+    // The FIFO keeps transactions in order and the state machine releases
+    // CS itself, so once the DMA is done there is nothing left to close
+}
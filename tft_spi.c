@@ -0,0 +1,100 @@
+#include "tft_bus.h"
+#include "pico/stdlib.h"
+#include "hardware/spi.h"
+#include "hardware/gpio.h"
+#include "hardware/dma.h"
+
+// SPI transport: the SPI block clocks the bits, the CPU drives CS and D/C
+#define TFT_SPI         spi0
+#define TFT_SPI_BAUD    (62500 * 1000) // 62.5 MHz requested
+
+const char *const tft_bus_name = "SPI";
+
+static int tft_dma_chan = -1;
+
+void tft_bus_init(void) {
+    spi_init(TFT_SPI, TFT_SPI_BAUD);
+    gpio_set_function(TFT_CLK, GPIO_FUNC_SPI);
+    gpio_set_function(TFT_MOSI, GPIO_FUNC_SPI);
+
+    // CS, DC as outputs
+    gpio_init(TFT_CS);
+    gpio_set_dir(TFT_CS, GPIO_OUT);
+    gpio_put(TFT_CS, 1);
+
+    gpio_init(TFT_DC);
+    gpio_set_dir(TFT_DC, GPIO_OUT);
+
+    // DMA channel for pixel data
+    tft_dma_chan = dma_claim_unused_channel(true);
+}
+
+static void tft_spi_write(bool dc, const uint8_t *data, uint32_t len) {
+    gpio_put(TFT_DC, dc);
+    gpio_put(TFT_CS, 0);
+    spi_write_blocking(TFT_SPI, data, len);
+    gpio_put(TFT_CS, 1);
+}
+
+void tft_bus_command(uint8_t cmd) {
+    tft_spi_write(false, &cmd, 1);
+}
+
+void tft_bus_data(const uint8_t *data, uint32_t len) {
+    tft_spi_write(true, data, len);
+}
+
+// The whole stream shares one CS frame; spi_write_blocking() returns once
+// the bytes are out, so D/C can be switched between records
+void tft_bus_batch(const uint8_t *buf, uint32_t len) {
+    const uint8_t *end = buf + len;
+
+    gpio_put(TFT_CS, 0);
+    while (buf < end) {
+        uint16_t count = buf[1] | (buf[2] << 8);
+
+        gpio_put(TFT_DC, 0);
+        spi_write_blocking(TFT_SPI, buf, 1);
+        if (count) {
+            gpio_put(TFT_DC, 1);
+            spi_write_blocking(TFT_SPI, buf + 3, count);
+        }
+        buf += 3 + count;
+    }
+    gpio_put(TFT_CS, 1);
+}
+
+// Open a RAMWR data phase. The SPI is switched to 16-bit frames so native
+// RGB565 values go out MSB first, which is the byte order the ST7796 expects.
+void tft_bus_pixels_begin(void) {
+    gpio_put(TFT_DC, 1);
+    gpio_put(TFT_CS, 0);
+    spi_set_format(TFT_SPI, 16, SPI_CPOL_0, SPI_CPHA_0, SPI_MSB_FIRST);
+}
+
+void tft_bus_pixels(const uint16_t *src, uint32_t count, bool increment) {
+    dma_channel_config c = dma_channel_get_default_config(tft_dma_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, increment);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, spi_get_dreq(TFT_SPI, true));
+
+    dma_channel_configure(tft_dma_chan, &c, &spi_get_hw(TFT_SPI)->dr, src, count, true);
+}
+
+bool tft_bus_pixels_busy(void) {
+    return dma_channel_is_busy(tft_dma_chan);
+}
+
+void tft_bus_pixels_wait(void) {
+    dma_channel_wait_for_finish_blocking(tft_dma_chan);
+}
+
+// Close the data phase once the last frame has left the shift register
+void tft_bus_pixels_end(void) {
+    while (spi_is_busy(TFT_SPI)) {
+        tight_loop_contents();
+    }
+    gpio_put(TFT_CS, 1);
+    spi_set_format(TFT_SPI, 8, SPI_CPOL_0, SPI_CPHA_0, SPI_MSB_FIRST);
+}
@@ -0,0 +1,96 @@
+#include "tiles.h"
+#include <string.h>
+
+// Two RGB565 pixels; may_alias lets it overlay the uint16_t buffer
+typedef uint32_t __attribute__((may_alias)) pixel_pair_t;
+
+// FNV-1a over pixel pairs. A collision would leave one stale tile until
+// its contents change again, which at 32 bits is not worth guarding.
+static uint32_t tile_hash(const sprite_t *tile) {
+    const pixel_pair_t *p = (const pixel_pair_t *)tile->buffer;
+    uint32_t n = (uint32_t)tile->width * tile->height;
+    uint32_t h = 2166136261u;
+
+    for (uint32_t i = 0; i < n / 2; i++) {
+        h = (h ^ p[i]) * 16777619u;
+    }
+    if (n & 1) {
+        h = (h ^ tile->buffer[n - 1]) * 16777619u;
+    }
+    return h;
+}
+
+static inline bool tile_dirty(const tile_renderer_t *tr, uint16_t i) {
+    return tr->dirty[i / 8] & (1u << (i % 8));
+}
+
+void tiles_init(tile_renderer_t *tr) {
+    memset(tr, 0, sizeof(*tr));
+    memset(tr->dirty, 0xFF, sizeof(tr->dirty));
+}
+
+void tiles_invalidate(tile_renderer_t *tr, int16_t x, int16_t y, int16_t w, int16_t h) {
+    int16_t x1 = x + w - 1;
+    int16_t y1 = y + h - 1;
+
+    if (x < 0) x = 0;
+    if (y < 0) y = 0;
+    if (x1 >= TFT_WIDTH) x1 = TFT_WIDTH - 1;
+    if (y1 >= TFT_HEIGHT) y1 = TFT_HEIGHT - 1;
+    if (x > x1 || y > y1) return;
+
+    for (int16_t row = y / TILE_SIZE; row <= y1 / TILE_SIZE; row++) {
+        for (int16_t col = x / TILE_SIZE; col <= x1 / TILE_SIZE; col++) {
+            uint16_t i = row * TILE_COLS + col;
+            tr->dirty[i / 8] |= 1u << (i % 8);
+        }
+    }
+}
+
+void tiles_render(tile_renderer_t *tr, const display_list_t *dl) {
+    bool scene_changed = dl->stamp != tr->stamp;
+    uint8_t next = 0;
+
+    tr->stats.rendered = 0;
+    tr->stats.sent = 0;
+
+    for (uint16_t row = 0; row < TILE_ROWS; row++) {
+        for (uint16_t col = 0; col < TILE_COLS; col++) {
+            uint16_t i = row * TILE_COLS + col;
+            bool forced = tile_dirty(tr, i);
+            if (!scene_changed && !forced) continue;
+
+            // Edge tiles are narrower or shorter when the panel size is
+            // not a multiple of the tile size
+            int16_t x = col * TILE_SIZE;
+            int16_t y = row * TILE_SIZE;
+            sprite_t tile = {
+                .buffer = tr->buf[next],
+                .width = TFT_WIDTH - x < TILE_SIZE ? TFT_WIDTH - x : TILE_SIZE,
+                .height = TFT_HEIGHT - y < TILE_SIZE ? TFT_HEIGHT - y : TILE_SIZE,
+            };
+
+            // The other buffer may still be on its way out; this one
+            // finished before that push started
+            display_list_render(dl, &tile, x, y);
+            tr->stats.rendered++;
+
+            uint32_t h = tile_hash(&tile);
+            if (!forced && h == tr->hash[i]) continue;
+
+            sprite_push_start(&tile, x, y);
+            tr->hash[i] = h;
+            tr->stats.sent++;
+            next ^= 1;
+        }
+    }
+
+    display_wait();
+    memset(tr->dirty, 0, sizeof(tr->dirty));
+    tr->stamp = dl->stamp;
+    tr->stats.frames++;
+}
+
+const tile_stats_t* tiles_stats(const tile_renderer_t *tr) {
+    return &tr->stats;
+}
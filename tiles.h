@@ -0,0 +1,49 @@
+#ifndef TILES_H
+#define TILES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "display.h"
+#include "displaylist.h"
+
+// Tile edge in pixels; the panel is covered by a grid of these
+#define TILE_SIZE   32
+#define TILE_COLS   ((TFT_WIDTH + TILE_SIZE - 1) / TILE_SIZE)
+#define TILE_ROWS   ((TFT_HEIGHT + TILE_SIZE - 1) / TILE_SIZE)
+#define TILE_COUNT  (TILE_COLS * TILE_ROWS)
+
+typedef struct {
+    uint16_t rendered;        // Tiles rasterized for the last frame
+    uint16_t sent;            // Tiles whose contents changed and were pushed
+    uint32_t frames;          // Frames presented since init
+} tile_stats_t;
+
+// Full-screen renderer that never holds more than two tiles of pixels.
+// Each tile is rasterized from a display list into a scratch buffer and
+// hashed; only tiles whose hash differs from what was last sent go out.
+// While one tile is being pushed by DMA the next is being rasterized.
+typedef struct {
+    uint16_t buf[2][TILE_SIZE * TILE_SIZE];
+    uint32_t hash[TILE_COUNT];       // Hash of what the panel shows per tile
+    uint8_t dirty[(TILE_COUNT + 7) / 8];
+    uint32_t stamp;                  // Scene stamp the panel reflects
+
+    tile_stats_t stats;
+} tile_renderer_t;
+
+// The panel contents are unknown, so the first render sends every tile
+void tiles_init(tile_renderer_t *tr);
+
+// Something else drew over this area of the panel; its tiles are
+// re-rendered and re-sent on the next frame regardless of their hash
+void tiles_invalidate(tile_renderer_t *tr, int16_t x, int16_t y, int16_t w, int16_t h);
+
+// Bring the panel up to date with a full-screen scene (TFT_WIDTH by
+// TFT_HEIGHT) that starts with a fill, since tiles are not cleared
+// between uses. Nothing is rasterized unless the scene changed or tiles
+// were invalidated. Only the thread that owns the display may call this.
+void tiles_render(tile_renderer_t *tr, const display_list_t *dl);
+
+const tile_stats_t* tiles_stats(const tile_renderer_t *tr);
+
+#endif // TILES_H
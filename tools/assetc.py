@@ -0,0 +1,795 @@
+#!/usr/bin/env python3
+"""Convert images and fonts into C arrays for the firmware.
+
+Reads an asset manifest and writes assets.c / assets.h. Everything is
+emitted as const data, so on the Pico it stays in flash and is read
+through XIP with no copy or decode at startup.
+
+Manifest lines (paths are relative to the manifest; a word starting with
+'#' starts a comment):
+
+    sprite <name> <file.png> [format=auto|index1|index2|index4|index8|rle8] [bg=#rrggbb]
+    font   <name> <file.ttf> size=<px> [ranges=32-126,160-255]
+
+Sprites become indexed_sprite_t (display.h) with their own palette.
+Transparent pixels are blended over `bg` (default white). The auto
+format picks the smallest of the packed formats that fits the color
+count and RLE8.
+
+Fonts become font_t (font.h): 4-bit antialiased glyph bitmaps rendered
+from the TrueType outlines, unhinted.
+
+Only the Python standard library is used.
+"""
+
+import argparse
+import os
+import struct
+import sys
+import zlib
+
+SPRITE_FORMATS = ['index1', 'index2', 'index4', 'index8', 'rle8']
+FORMAT_ENUM = {
+    'index1': 'SPRITE_INDEX1',
+    'index2': 'SPRITE_INDEX2',
+    'index4': 'SPRITE_INDEX4',
+    'index8': 'SPRITE_INDEX8',
+    'rle8': 'SPRITE_RLE8',
+}
+
+
+class AssetError(Exception):
+    pass
+
+
+# ===== PNG =====
+
+def _paeth(a, b, c):
+    p = a + b - c
+    pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    return b if pb <= pc else c
+
+
+def read_png(path):
+    """Decode a non-interlaced PNG into (width, height, [(r, g, b, a), ...])."""
+    with open(path, 'rb') as f:
+        data = f.read()
+    if data[:8] != b'\x89PNG\r\n\x1a\n':
+        raise AssetError(f'{path}: not a PNG file')
+
+    pos = 8
+    idat = b''
+    palette = []
+    trns = b''
+    while pos < len(data):
+        length, kind = struct.unpack('>I4s', data[pos:pos + 8])
+        body = data[pos + 8:pos + 8 + length]
+        pos += 12 + length
+        if kind == b'IHDR':
+            width, height, depth, ctype, _, _, interlace = struct.unpack('>IIBBBBB', body)
+        elif kind == b'PLTE':
+            palette = [tuple(body[i:i + 3]) for i in range(0, len(body), 3)]
+        elif kind == b'tRNS':
+            trns = body
+        elif kind == b'IDAT':
+            idat += body
+        elif kind == b'IEND':
+            break
+
+    if interlace:
+        raise AssetError(f'{path}: interlaced PNGs are not supported')
+    channels = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}.get(ctype)
+    if channels is None:
+        raise AssetError(f'{path}: unknown color type {ctype}')
+
+    bits = channels * depth
+    stride = (width * bits + 7) // 8
+    step = max(1, bits // 8)
+    raw = zlib.decompress(idat)
+
+    # Undo the per-row filters
+    rows = []
+    prev = bytearray(stride)
+    for y in range(height):
+        base = y * (stride + 1)
+        ftype = raw[base]
+        row = bytearray(raw[base + 1:base + 1 + stride])
+        for i in range(stride):
+            a = row[i - step] if i >= step else 0
+            b = prev[i]
+            c = prev[i - step] if i >= step else 0
+            if ftype == 1:
+                row[i] = (row[i] + a) & 0xFF
+            elif ftype == 2:
+                row[i] = (row[i] + b) & 0xFF
+            elif ftype == 3:
+                row[i] = (row[i] + ((a + b) >> 1)) & 0xFF
+            elif ftype == 4:
+                row[i] = (row[i] + _paeth(a, b, c)) & 0xFF
+        rows.append(row)
+        prev = row
+
+    def samples(row):
+        if depth == 8:
+            return list(row)
+        if depth == 16:
+            return [row[i] for i in range(0, len(row), 2)]
+        per = 8 // depth
+        mask = (1 << depth) - 1
+        out = []
+        for byte in row:
+            for k in range(per):
+                out.append((byte >> (8 - depth * (k + 1))) & mask)
+        return out
+
+    pixels = []
+    scale = 255 // ((1 << depth) - 1) if depth < 8 else 1
+    for row in rows:
+        s = samples(row)
+        for x in range(width):
+            v = s[x * channels:(x + 1) * channels]
+            if ctype == 3:
+                r, g, b = palette[v[0]]
+                a = trns[v[0]] if v[0] < len(trns) else 255
+            elif ctype == 0:
+                r = g = b = v[0] * scale
+                a = 255
+            elif ctype == 4:
+                r = g = b = v[0]
+                a = v[1]
+            elif ctype == 2:
+                r, g, b = v
+                a = 255
+            else:
+                r, g, b, a = v
+            pixels.append((r, g, b, a))
+    return width, height, pixels
+
+
+# ===== SPRITES =====
+
+def rgb565(r, g, b):
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3)
+
+
+def rle8(indices):
+    """PackBits-style runs, matching the SPRITE_RLE8 decoder in sprite_fmt.c."""
+    out = bytearray()
+    literal = []
+
+    def flush_literal():
+        while literal:
+            chunk = literal[:128]
+            del literal[:128]
+            out.append(len(chunk) - 1)
+            out.extend(chunk)
+
+    i = 0
+    n = len(indices)
+    while i < n:
+        run = 1
+        while i + run < n and run < 128 and indices[i + run] == indices[i]:
+            run += 1
+        # Two equal pixels are cheaper as part of a literal
+        if run >= 3:
+            flush_literal()
+            out.append(0x80 | (run - 1))
+            out.append(indices[i])
+            i += run
+        else:
+            literal.extend(indices[i:i + run])
+            i += run
+    flush_literal()
+    return bytes(out)
+
+
+def pack(indices, width, height, bpp):
+    out = bytearray()
+    for y in range(height):
+        byte = 0
+        used = 0
+        for x in range(width):
+            byte = (byte << bpp) | indices[y * width + x]
+            used += bpp
+            if used == 8:
+                out.append(byte)
+                byte = used = 0
+        if used:
+            out.append(byte << (8 - used))
+    return bytes(out)
+
+
+def parse_color(text):
+    text = text.lstrip('#')
+    if len(text) != 6:
+        raise AssetError(f'bad color "{text}"')
+    v = int(text, 16)
+    return (v >> 16) & 0xFF, (v >> 8) & 0xFF, v & 0xFF
+
+
+def convert_sprite(path, fmt, bg):
+    width, height, pixels = read_png(path)
+
+    palette = []
+    lookup = {}
+    indices = []
+    for r, g, b, a in pixels:
+        if a < 255:
+            r = (r * a + bg[0] * (255 - a)) // 255
+            g = (g * a + bg[1] * (255 - a)) // 255
+            b = (b * a + bg[2] * (255 - a)) // 255
+        c = rgb565(r, g, b)
+        if c not in lookup:
+            lookup[c] = len(palette)
+            palette.append(c)
+        indices.append(lookup[c])
+
+    if len(palette) > 256:
+        raise AssetError(f'{path}: {len(palette)} colors after RGB565 conversion, at most 256 fit')
+
+    candidates = {}
+    for bpp, name in ((1, 'index1'), (2, 'index2'), (4, 'index4'), (8, 'index8')):
+        if len(palette) <= 1 << bpp:
+            candidates[name] = pack(indices, width, height, bpp)
+            break
+    candidates['rle8'] = rle8(indices)
+
+    if fmt == 'auto':
+        fmt = min(candidates, key=lambda k: len(candidates[k]))
+    elif fmt not in candidates:
+        bpp = 1 << SPRITE_FORMATS.index(fmt)
+        if len(palette) > 1 << bpp:
+            raise AssetError(f'{path}: {len(palette)} colors do not fit {fmt}')
+        candidates[fmt] = pack(indices, width, height, bpp)
+
+    return {
+        'width': width,
+        'height': height,
+        'format': fmt,
+        'palette': palette,
+        'data': candidates[fmt],
+    }
+
+
+# ===== TRUETYPE =====
+
+class TrueType:
+    """Just enough of the TrueType format to get glyph outlines and metrics."""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+        self.path = path
+
+        num_tables = struct.unpack('>H', self.data[4:6])[0]
+        self.tables = {}
+        for i in range(num_tables):
+            tag, _, offset, length = struct.unpack('>4sIII', self.data[12 + 16 * i:28 + 16 * i])
+            self.tables[tag.decode('latin-1')] = (offset, length)
+        for tag in ('head', 'hhea', 'hmtx', 'maxp', 'cmap', 'loca', 'glyf'):
+            if tag not in self.tables:
+                raise AssetError(f'{path}: missing "{tag}" table (CFF fonts are not supported)')
+
+        head = self.tables['head'][0]
+        self.units_per_em = self.u16(head + 18)
+        self.long_loca = self.i16(head + 50) == 1
+        self.num_glyphs = self.u16(self.tables['maxp'][0] + 4)
+
+        hhea = self.tables['hhea'][0]
+        self.ascender = self.i16(hhea + 4)
+        self.descender = self.i16(hhea + 6)
+        self.line_gap = self.i16(hhea + 8)
+        self.num_hmetrics = self.u16(hhea + 34)
+
+        self.cmap = self._read_cmap()
+
+    def u16(self, pos):
+        return struct.unpack('>H', self.data[pos:pos + 2])[0]
+
+    def i16(self, pos):
+        return struct.unpack('>h', self.data[pos:pos + 2])[0]
+
+    def u32(self, pos):
+        return struct.unpack('>I', self.data[pos:pos + 4])[0]
+
+    def _read_cmap(self):
+        base = self.tables['cmap'][0]
+        subtables = {}
+        for i in range(self.u16(base + 2)):
+            rec = base + 4 + 8 * i
+            subtables[(self.u16(rec), self.u16(rec + 2))] = base + self.u32(rec + 4)
+
+        for key in ((3, 10), (0, 4), (3, 1), (0, 3)):
+            if key in subtables:
+                return self._read_cmap_subtable(subtables[key])
+        raise AssetError(f'{self.path}: no Unicode cmap')
+
+    def _read_cmap_subtable(self, pos):
+        fmt = self.u16(pos)
+        mapping = {}
+        if fmt == 4:
+            segs = self.u16(pos + 6) // 2
+            ends = pos + 14
+            starts = ends + 2 * segs + 2
+            deltas = starts + 2 * segs
+            range_offsets = deltas + 2 * segs
+            for s in range(segs):
+                end = self.u16(ends + 2 * s)
+                start = self.u16(starts + 2 * s)
+                delta = self.u16(deltas + 2 * s)
+                ro_pos = range_offsets + 2 * s
+                ro = self.u16(ro_pos)
+                for c in range(start, end + 1):
+                    if c == 0xFFFF:
+                        continue
+                    if ro == 0:
+                        g = (c + delta) & 0xFFFF
+                    else:
+                        g = self.u16(ro_pos + ro + 2 * (c - start))
+                        if g:
+                            g = (g + delta) & 0xFFFF
+                    if g:
+                        mapping[c] = g
+        elif fmt == 12:
+            for i in range(self.u32(pos + 12)):
+                rec = pos + 16 + 12 * i
+                start, end, glyph = struct.unpack('>III', self.data[rec:rec + 12])
+                for c in range(start, end + 1):
+                    mapping[c] = glyph + c - start
+        else:
+            raise AssetError(f'{self.path}: cmap format {fmt} is not supported')
+        return mapping
+
+    def advance(self, glyph):
+        hmtx = self.tables['hmtx'][0]
+        return self.u16(hmtx + 4 * min(glyph, self.num_hmetrics - 1))
+
+    def _glyph_range(self, glyph):
+        loca = self.tables['loca'][0]
+        if self.long_loca:
+            start, end = self.u32(loca + 4 * glyph), self.u32(loca + 4 * glyph + 4)
+        else:
+            start, end = 2 * self.u16(loca + 2 * glyph), 2 * self.u16(loca + 2 * glyph + 2)
+        return self.tables['glyf'][0] + start, end - start
+
+    def contours(self, glyph):
+        """Closed contours of (x, y, on_curve) points in font units."""
+        pos, length = self._glyph_range(glyph)
+        if length == 0:
+            return []
+
+        count = self.i16(pos)
+        if count < 0:
+            return self._compound(pos)
+
+        ends = [self.u16(pos + 10 + 2 * i) for i in range(count)]
+        npoints = ends[-1] + 1 if ends else 0
+        p = pos + 10 + 2 * count
+        p += 2 + self.u16(p)  # Skip instructions
+
+        flags = []
+        while len(flags) < npoints:
+            flag = self.data[p]
+            p += 1
+            flags.append(flag)
+            if flag & 8:
+                flags.extend([flag] * self.data[p])
+                p += 1
+
+        def coords(short_bit, same_bit):
+            nonlocal p
+            values = []
+            v = 0
+            for flag in flags[:npoints]:
+                if flag & short_bit:
+                    d = self.data[p]
+                    p += 1
+                    v += d if flag & same_bit else -d
+                elif not flag & same_bit:
+                    v += self.i16(p)
+                    p += 2
+                values.append(v)
+            return values
+
+        xs = coords(2, 16)
+        ys = coords(4, 32)
+
+        result = []
+        start = 0
+        for end in ends:
+            result.append([(xs[i], ys[i], bool(flags[i] & 1)) for i in range(start, end + 1)])
+            start = end + 1
+        return result
+
+    def _compound(self, pos):
+        result = []
+        p = pos + 10
+        while True:
+            flags = self.u16(p)
+            glyph = self.u16(p + 2)
+            p += 4
+            if flags & 1:
+                dx, dy = self.i16(p), self.i16(p + 2)
+                p += 4
+            else:
+                dx, dy = struct.unpack('>bb', self.data[p:p + 2])
+                p += 2
+            if not flags & 2:
+                dx = dy = 0  # Point matching is not supported
+
+            a, b, c, d = 1.0, 0.0, 0.0, 1.0
+            if flags & 8:
+                a = d = self.i16(p) / 16384
+                p += 2
+            elif flags & 0x40:
+                a, d = self.i16(p) / 16384, self.i16(p + 2) / 16384
+                p += 4
+            elif flags & 0x80:
+                a, b, c, d = (self.i16(p + 2 * k) / 16384 for k in range(4))
+                p += 8
+
+            for contour in self.contours(glyph):
+                result.append([(a * x + c * y + dx, b * x + d * y + dy, on)
+                               for x, y, on in contour])
+            if not flags & 0x20:
+                return result
+
+
+def flatten(contour, scale, steps=6):
+    """Polyline through a quadratic B-spline contour, scaled to pixels with y down."""
+    pts = [(x * scale, -y * scale, on) for x, y, on in contour]
+    if not pts:
+        return []
+
+    # Start on an on-curve point, inventing one between two off-curve points
+    start = next((i for i, p in enumerate(pts) if p[2]), None)
+    if start is None:
+        a, b = pts[0], pts[1]
+        pts.insert(0, ((a[0] + b[0]) / 2, (a[1] + b[1]) / 2, True))
+        start = 0
+    pts = pts[start:] + pts[:start]
+
+    out = [pts[0][:2]]
+    ctrl = None
+    for x, y, on in pts[1:] + [pts[0]]:
+        if on:
+            if ctrl is None:
+                out.append((x, y))
+            else:
+                out.extend(_quad(out[-1], ctrl, (x, y), steps))
+                ctrl = None
+        else:
+            if ctrl is not None:
+                mid = ((ctrl[0] + x) / 2, (ctrl[1] + y) / 2)
+                out.extend(_quad(out[-1], ctrl, mid, steps))
+            ctrl = (x, y)
+    return out
+
+
+def _quad(p0, p1, p2, steps):
+    pts = []
+    for i in range(1, steps + 1):
+        t = i / steps
+        u = 1 - t
+        pts.append((u * u * p0[0] + 2 * u * t * p1[0] + t * t * p2[0],
+                    u * u * p0[1] + 2 * u * t * p1[1] + t * t * p2[1]))
+    return pts
+
+
+def rasterize(polys, subsamples=8):
+    """Non-zero coverage of polylines as 0..15, exact horizontally."""
+    xs = [x for poly in polys for x, _ in poly]
+    ys = [y for poly in polys for _, y in poly]
+    if not xs:
+        return 0, 0, 0, 0, []
+
+    x0 = int(min(xs) // 1)
+    y0 = int(min(ys) // 1)
+    width = int(-(-max(xs) // 1)) - x0
+    height = int(-(-max(ys) // 1)) - y0
+
+    edges = []
+    for poly in polys:
+        for i in range(len(poly)):
+            ax, ay = poly[i]
+            bx, by = poly[(i + 1) % len(poly)]
+            if ay != by:
+                edges.append((ax - x0, ay - y0, bx - x0, by - y0))
+
+    cover = [0.0] * (width * height)
+    for row in range(height):
+        for s in range(subsamples):
+            y = row + (s + 0.5) / subsamples
+            hits = []
+            for ax, ay, bx, by in edges:
+                if (ay <= y < by) or (by <= y < ay):
+                    hits.append((ax + (y - ay) * (bx - ax) / (by - ay), 1 if by > ay else -1))
+            hits.sort()
+
+            winding = 0
+            for k in range(len(hits) - 1):
+                winding += hits[k][1]
+                if winding == 0:
+                    continue
+                xa, xb = max(hits[k][0], 0.0), min(hits[k + 1][0], float(width))
+                col = int(xa)
+                while col < xb:
+                    overlap = min(xb, col + 1) - max(xa, col)
+                    if overlap > 0:
+                        cover[row * width + col] += overlap / subsamples
+                    col += 1
+
+    levels = [min(15, int(c * 15 + 0.5)) for c in cover]
+    return x0, y0, width, height, levels
+
+
+def parse_ranges(text):
+    ranges = []
+    for part in text.split(','):
+        lo, _, hi = part.partition('-')
+        lo = int(lo, 0)
+        hi = int(hi, 0) if hi else lo
+        if hi < lo:
+            raise AssetError(f'bad range "{part}"')
+        ranges.append((lo, hi))
+    return sorted(ranges)
+
+
+def convert_font(path, size, ranges):
+    font = TrueType(path)
+    scale = size / font.units_per_em
+    notdef = 0
+
+    glyphs = []
+    bitmap = bytearray()
+    for lo, hi in ranges:
+        for code in range(lo, hi + 1):
+            glyph = font.cmap.get(code, notdef)
+            polys = [flatten(c, scale) for c in font.contours(glyph)]
+            x0, y0, w, h, levels = rasterize([p for p in polys if len(p) > 2])
+            if w > 255 or h > 255 or not -128 <= x0 < 128 or not -128 <= y0 < 128:
+                raise AssetError(f'{path}: glyph U+{code:04X} is too large')
+
+            glyphs.append({
+                'code': code,
+                'offset': len(bitmap),
+                'width': w,
+                'height': h,
+                'x_offset': x0,
+                'y_offset': y0,
+                'advance': int(font.advance(glyph) * scale + 0.5),
+            })
+            bitmap += pack(levels, w, h, 4)
+
+    ascent = int(font.ascender * scale + 0.5)
+    descent = int(-font.descender * scale + 0.5)
+    return {
+        'size': size,
+        'ranges': ranges,
+        'glyphs': glyphs,
+        'bitmap': bytes(bitmap),
+        'ascent': ascent,
+        'line_height': ascent + descent + int(font.line_gap * scale + 0.5),
+    }
+
+
+# ===== MANIFEST =====
+
+def parse_manifest(path):
+    entries = []
+    base = os.path.dirname(os.path.abspath(path))
+    with open(path) as f:
+        for lineno, line in enumerate(f, 1):
+            line = line.split()
+            for i, token in enumerate(line):
+                if token.startswith('#'):
+                    del line[i:]
+                    break
+            if not line:
+                continue
+            if len(line) < 3 or line[0] not in ('sprite', 'font'):
+                raise AssetError(f'{path}:{lineno}: expected "sprite|font <name> <file> [key=value ...]"')
+
+            kind, name, source = line[:3]
+            if not name.isidentifier():
+                raise AssetError(f'{path}:{lineno}: "{name}" is not a C identifier')
+            options = {}
+            for opt in line[3:]:
+                key, sep, value = opt.partition('=')
+                if not sep:
+                    raise AssetError(f'{path}:{lineno}: option "{opt}" is not key=value')
+                options[key] = value
+            entries.append({
+                'kind': kind,
+                'name': name,
+                'source': os.path.join(base, source),
+                'options': options,
+                'where': f'{path}:{lineno}',
+            })
+    return entries
+
+
+# ===== OUTPUT =====
+
+class Blob:
+    """All pixel data in one aligned array, each item starting on a word."""
+
+    def __init__(self):
+        self.data = bytearray()
+
+    def add(self, data):
+        while len(self.data) % 4:
+            self.data.append(0)
+        offset = len(self.data)
+        self.data += data
+        return offset
+
+
+def c_bytes(data, indent='    '):
+    lines = []
+    for i in range(0, len(data), 16):
+        lines.append(indent + ', '.join(f'0x{b:02x}' for b in data[i:i + 16]) + ',')
+    return '\n'.join(lines)
+
+
+def c_words(values, indent='    '):
+    lines = []
+    for i in range(0, len(values), 8):
+        lines.append(indent + ', '.join(f'0x{v:04x}' for v in values[i:i + 8]) + ',')
+    return '\n'.join(lines)
+
+
+def generate(entries, manifest):
+    blob = Blob()
+    sprites = []
+    fonts = []
+
+    for e in entries:
+        opts = e['options']
+        try:
+            if e['kind'] == 'sprite':
+                fmt = opts.get('format', 'auto')
+                if fmt != 'auto' and fmt not in SPRITE_FORMATS:
+                    raise AssetError(f'unknown format "{fmt}"')
+                s = convert_sprite(e['source'], fmt, parse_color(opts.get('bg', '#ffffff')))
+                s['name'] = e['name']
+                s['offset'] = blob.add(s['data'])
+                sprites.append(s)
+            else:
+                if 'size' not in opts:
+                    raise AssetError('fonts need size=<px>')
+                f = convert_font(e['source'], int(opts['size']), parse_ranges(opts.get('ranges', '32-126')))
+                f['name'] = e['name']
+                f['offset'] = blob.add(f['bitmap'])
+                fonts.append(f)
+        except AssetError as err:
+            raise AssetError(f'{e["where"]}: {err}')
+        except OSError as err:
+            raise AssetError(f'{e["where"]}: {err.strerror}: {err.filename}')
+
+    src = os.path.relpath(manifest, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+    banner = f'// Generated by tools/assetc.py from {src}; do not edit\n'
+
+    h = [banner, '#ifndef ASSETS_H', '#define ASSETS_H', '',
+         '#include "display.h"', '#include "font.h"', '']
+    c = [banner, '#include "assets.h"', '']
+
+    # One aligned array for everything, so pixel rows can be read as words
+    c.append(f'static const uint8_t asset_blob[{max(len(blob.data), 1)}] __attribute__((aligned(4))) = {{')
+    c.append(c_bytes(blob.data) if blob.data else '    0,')
+    c.append('};')
+    c.append('')
+
+    if sprites:
+        h.append('// Sprites; copy the palette to RAM to recolor')
+    for s in sprites:
+        n = len(s['palette'])
+        h.append(f'extern const indexed_sprite_t asset_{s["name"]};'
+                 f'   // {s["width"]}x{s["height"]} {s["format"]}, {len(s["data"])} bytes')
+        h.append(f'extern const uint16_t asset_{s["name"]}_palette[{n}];')
+
+        c.append(f'const uint16_t asset_{s["name"]}_palette[{n}] = {{')
+        c.append(c_words(s['palette']))
+        c.append('};')
+        c.append('')
+        c.append(f'const indexed_sprite_t asset_{s["name"]} = {{')
+        c.append(f'    .data = asset_blob + {s["offset"]},')
+        c.append(f'    .palette = asset_{s["name"]}_palette,')
+        c.append(f'    .width = {s["width"]},')
+        c.append(f'    .height = {s["height"]},')
+        c.append(f'    .format = {FORMAT_ENUM[s["format"]]},')
+        c.append('};')
+        c.append('')
+    if sprites:
+        h.append('')
+
+    if fonts:
+        h.append('// Fonts')
+    for f in fonts:
+        name = f['name']
+        h.append(f'extern const font_t asset_{name};'
+                 f'   // {f["size"]} px, {len(f["glyphs"])} glyphs, {len(f["bitmap"])} bytes')
+
+        c.append(f'static const font_glyph_t asset_{name}_glyphs[{len(f["glyphs"])}] = {{')
+        for g in f['glyphs']:
+            ch = chr(g['code'])
+            note = f' // {ch}' if ch.isprintable() and ch != '\\' and ord(ch) < 0x7F else f' // U+{g["code"]:04X}'
+            c.append(f'    {{{g["offset"]}, {g["width"]}, {g["height"]}, {g["x_offset"]}, '
+                     f'{g["y_offset"]}, {g["advance"]}}},{note}')
+        c.append('};')
+        c.append('')
+
+        c.append(f'static const font_range_t asset_{name}_ranges[{len(f["ranges"])}] = {{')
+        index = 0
+        for lo, hi in f['ranges']:
+            c.append(f'    {{{lo}, {hi - lo + 1}, {index}}},')
+            index += hi - lo + 1
+        c.append('};')
+        c.append('')
+
+        c.append(f'const font_t asset_{name} = {{')
+        c.append(f'    .bitmap = asset_blob + {f["offset"]},')
+        c.append(f'    .glyphs = asset_{name}_glyphs,')
+        c.append(f'    .ranges = asset_{name}_ranges,')
+        c.append(f'    .range_count = {len(f["ranges"])},')
+        c.append(f'    .ascent = {f["ascent"]},')
+        c.append(f'    .line_height = {f["line_height"]},')
+        c.append('};')
+        c.append('')
+    if fonts:
+        h.append('')
+
+    # Atlas index: look assets up by id as well as by name
+    for kind, items, ctype in (('SPRITE', sprites, 'indexed_sprite_t'), ('FONT', fonts, 'font_t')):
+        if not items:
+            continue
+        h.append('typedef enum {')
+        for item in items:
+            h.append(f'    ASSET_{kind}_{item["name"].upper()},')
+        h.append(f'    ASSET_{kind}_COUNT')
+        h.append(f'}} asset_{kind.lower()}_id_t;')
+        h.append('')
+        table = f'asset_{kind.lower()}s'
+        h.append(f'extern const {ctype} *const {table}[ASSET_{kind}_COUNT];')
+        h.append('')
+
+        c.append(f'const {ctype} *const {table}[ASSET_{kind}_COUNT] = {{')
+        for item in items:
+            c.append(f'    &asset_{item["name"]},')
+        c.append('};')
+        c.append('')
+
+    h.append('#endif // ASSETS_H')
+    return '\n'.join(h) + '\n', '\n'.join(c).rstrip('\n') + '\n'
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('manifest', help='asset manifest')
+    parser.add_argument('-o', '--output', default='.', help='directory for assets.c and assets.h')
+    parser.add_argument('--list', action='store_true',
+                        help='print the files the manifest refers to and exit')
+    args = parser.parse_args()
+
+    try:
+        entries = parse_manifest(args.manifest)
+        if args.list:
+            # Semicolon separated, so CMake can use it as a list
+            print(';'.join(e['source'] for e in entries), end='')
+            return 0
+
+        header, source = generate(entries, args.manifest)
+        os.makedirs(args.output, exist_ok=True)
+        for name, text in (('assets.h', header), ('assets.c', source)):
+            with open(os.path.join(args.output, name), 'w') as f:
+                f.write(text)
+    except (AssetError, OSError) as err:
+        print(f'assetc: {err}', file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,39 @@
+# Build-time asset conversion: tools/assetc.py turns the images and fonts
+# listed in assets/assets.txt into const C arrays (assets.c / assets.h in
+# the build tree), so they live in flash and need no decoding at startup.
+
+find_package(Python3 REQUIRED COMPONENTS Interpreter)
+
+set(LIL_GUY_ASSET_TOOL ${CMAKE_CURRENT_LIST_DIR}/assetc.py)
+set(LIL_GUY_ASSET_MANIFEST ${CMAKE_CURRENT_LIST_DIR}/../assets/assets.txt)
+set(LIL_GUY_ASSET_DIR ${CMAKE_BINARY_DIR}/assets)
+
+# Generate the assets and add them to `target`. The manifest is read at
+# configure time for the list of inputs, and editing it reconfigures.
+function(lil_guy_add_assets target)
+    execute_process(
+        COMMAND ${Python3_EXECUTABLE} ${LIL_GUY_ASSET_TOOL} --list ${LIL_GUY_ASSET_MANIFEST}
+        OUTPUT_VARIABLE asset_inputs
+        RESULT_VARIABLE result
+        )
+    if (NOT result EQUAL 0)
+        message(FATAL_ERROR "Could not read ${LIL_GUY_ASSET_MANIFEST}")
+    endif()
+    set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS ${LIL_GUY_ASSET_MANIFEST})
+
+    add_custom_command(
+        OUTPUT ${LIL_GUY_ASSET_DIR}/assets.c ${LIL_GUY_ASSET_DIR}/assets.h
+        COMMAND ${Python3_EXECUTABLE} ${LIL_GUY_ASSET_TOOL} ${LIL_GUY_ASSET_MANIFEST}
+                -o ${LIL_GUY_ASSET_DIR}
+        DEPENDS ${LIL_GUY_ASSET_TOOL} ${LIL_GUY_ASSET_MANIFEST} ${asset_inputs}
+        COMMENT "Converting assets"
+        VERBATIM
+        )
+    add_custom_target(${target}_assets
+        DEPENDS ${LIL_GUY_ASSET_DIR}/assets.c ${LIL_GUY_ASSET_DIR}/assets.h
+        )
+
+    add_dependencies(${target} ${target}_assets)
+    target_sources(${target} PRIVATE ${LIL_GUY_ASSET_DIR}/assets.c)
+    target_include_directories(${target} PRIVATE ${LIL_GUY_ASSET_DIR})
+endfunction()
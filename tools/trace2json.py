@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""Convert a Lil Guy trace capture into Chrome trace JSON.
+
+Build with -DLIL_GUY_TRACE=ON and capture the USB serial port to a file
+(or run the simulator with -T file), then:
+
+    tools/trace2json.py capture.bin -o trace.json
+
+and open trace.json in ui.perfetto.dev or chrome://tracing. Each core
+is a thread; zones are slices, async spans (e.g. touch reads) get their
+own track, and dropped records show up as instant markers.
+
+The capture may hold ordinary printf output between packets; anything
+that is not a packet with a valid checksum is skipped. See trace.c for
+the packet format. Only the Python standard library is used.
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+MAGIC = b'LGTR'
+HEADER = struct.Struct('<BBHI')
+RECORD = struct.Struct('<IBBH')
+
+PACKET_NAMES = 0
+PACKET_EVENTS = 1
+
+KIND_BEGIN = 0
+KIND_END = 1
+KIND_INSTANT = 2
+KIND_ASYNC_BEGIN = 3
+KIND_ASYNC_END = 4
+
+
+def fletcher16(data):
+    sum1 = sum2 = 0
+    for b in data:
+        sum1 = (sum1 + b) % 255
+        sum2 = (sum2 + sum1) % 255
+    return (sum2 << 8) | sum1
+
+
+def packets(capture):
+    """Yield (type, core, count, lost, payload) for every valid packet."""
+    pos = 0
+    while True:
+        pos = capture.find(MAGIC, pos)
+        if pos < 0:
+            return
+        start = pos + len(MAGIC)
+        head = capture[start:start + HEADER.size]
+        if len(head) < HEADER.size:
+            return
+        ptype, core, count, lost = HEADER.unpack(head)
+
+        body = start + HEADER.size
+        if ptype == PACKET_EVENTS:
+            end = body + count * RECORD.size
+        elif ptype == PACKET_NAMES:
+            end = body
+            for _ in range(count):
+                if end >= len(capture):
+                    break
+                end += 1 + capture[end]
+        else:
+            pos += 1
+            continue
+
+        check = capture[end:end + 2]
+        if len(check) == 2 and struct.unpack('<H', check)[0] == fletcher16(capture[start:end]):
+            yield ptype, core, count, lost, capture[body:end]
+            pos = end + 2
+        else:
+            pos += 1
+
+
+def parse_names(count, payload):
+    names = []
+    pos = 0
+    for _ in range(count):
+        n = payload[pos]
+        names.append(payload[pos + 1:pos + 1 + n].decode('ascii', 'replace'))
+        pos += 1 + n
+    return names
+
+
+def convert(capture):
+    names = []
+    records = []            # (core, time_us, zone, kind) in capture order
+    drops = []              # (core, time_us, lost)
+    last = {}               # core -> (raw 32-bit time, unwrapped time)
+
+    for ptype, core, count, lost, payload in packets(capture):
+        if ptype == PACKET_NAMES:
+            names = parse_names(count, payload)
+            continue
+
+        for i in range(count):
+            raw, zone, kind, _ = RECORD.unpack_from(payload, i * RECORD.size)
+            # The firmware sends the low 32 bits of the microsecond clock;
+            # a trace that outlives one wrap (~71 minutes) is unwrapped here
+            prev_raw, prev = last.get(core, (raw, raw))
+            now = prev + ((raw - prev_raw) & 0xFFFFFFFF)
+            last[core] = (raw, now)
+            records.append((core, now, zone, kind))
+        if lost:
+            drops.append((core, last.get(core, (0, 0))[1], lost))
+
+    def name(zone):
+        return names[zone] if zone < len(names) else f'zone{zone}'
+
+    events = []
+    for core in sorted({r[0] for r in records} | {d[0] for d in drops}):
+        events.append({'ph': 'M', 'name': 'thread_name', 'pid': 0, 'tid': core,
+                       'args': {'name': f'core{core}'}})
+
+    phases = {KIND_BEGIN: 'B', KIND_END: 'E', KIND_INSTANT: 'i',
+              KIND_ASYNC_BEGIN: 'b', KIND_ASYNC_END: 'e'}
+    for core, ts, zone, kind in records:
+        ev = {'name': name(zone), 'ph': phases.get(kind, 'i'), 'ts': ts, 'pid': 0, 'tid': core}
+        if kind in (KIND_ASYNC_BEGIN, KIND_ASYNC_END):
+            ev['cat'] = 'async'
+            ev['id'] = zone
+        elif kind == KIND_INSTANT or kind not in phases:
+            ev['s'] = 't'
+        events.append(ev)
+
+    for core, ts, lost in drops:
+        events.append({'name': f'dropped {lost}', 'ph': 'i', 's': 't', 'ts': ts,
+                       'pid': 0, 'tid': core, 'args': {'records': lost}})
+
+    return {'traceEvents': events, 'displayTimeUnit': 'ms'}, len(records), drops
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('capture', help='raw serial capture')
+    parser.add_argument('-o', '--output', default='-', help='JSON output (default stdout)')
+    args = parser.parse_args()
+
+    try:
+        with open(args.capture, 'rb') as f:
+            capture = f.read()
+        trace, count, drops = convert(capture)
+        text = json.dumps(trace, separators=(',', ':'))
+        if args.output == '-':
+            sys.stdout.write(text)
+        else:
+            with open(args.output, 'w') as f:
+                f.write(text)
+    except OSError as err:
+        print(f'trace2json: {err}', file=sys.stderr)
+        return 1
+
+    lost = sum(d[2] for d in drops)
+    print(f'trace2json: {count} records' + (f', {lost} dropped' if lost else ''), file=sys.stderr)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,281 @@
+#include "touch.h"
+#include "display.h"
+#include "spsc.h"
+#include "trace.h"
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "hardware/gpio.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+
+// Touch Screen - I2C (GT911)
+#define TOUCH_I2C       i2c0
+#define TOUCH_SDA       8
+#define TOUCH_SCL       9
+#define TOUCH_INT       28
+#define GT911_ADDR      0x5D
+#define GT911_SWITCH1   0x804D  // Bits 1:0 select the INT trigger mode
+#define GT911_STATUS    0x814E
+#define GT911_POINT1    0x814F
+
+// Status byte followed by one 8-byte record per point
+#define GT911_POINT_SIZE 8
+#define REPORT_LEN      (1 + TOUCH_MAX_POINTS * GT911_POINT_SIZE)
+
+// A transfer that has not finished by then is assumed lost (e.g. NACK)
+#define READ_TIMEOUT_US 20000
+
+#define EVENT_QUEUE_LEN 32
+
+static int tx_chan = -1;
+static int rx_chan = -1;
+static uint32_t gpio_events;
+
+// Register address, then a read command per byte (restart on the first,
+// stop on the last); built once at init
+static uint32_t read_cmds[2 + REPORT_LEN];
+static uint8_t report[REPORT_LEN];
+
+static volatile bool read_busy;
+static volatile bool read_again;
+static volatile uint64_t read_started_us;
+static volatile uint64_t report_time_us;
+
+// Points from the previous report, indexed by track id
+static struct {
+    uint16_t x;
+    uint16_t y;
+} last_points[16];
+static uint16_t last_ids;
+static volatile uint8_t active_count;
+
+static touch_event_t event_storage[EVENT_QUEUE_LEN];
+static spsc_t event_queue;
+
+// ===== I2C DMA TRANSFERS =====
+
+static void start_report_read(void) {
+    read_busy = true;
+    read_again = false;
+    read_started_us = time_us_64();
+    TRACE_ASYNC_BEGIN(TOUCH_READ);
+
+    // The target address is set once at init. Disabling the block here
+    // would flush the status clear that may still be going out, leaving
+    // the controller unable to latch the next report.
+    dma_channel_set_write_addr(rx_chan, report, false);
+    dma_channel_set_trans_count(rx_chan, REPORT_LEN, true);
+    dma_channel_set_read_addr(tx_chan, read_cmds, false);
+    dma_channel_set_trans_count(tx_chan, 2 + REPORT_LEN, true);
+}
+
+// Acknowledge the report so the controller can latch the next one. Three
+// entries fit in the (now empty) TX FIFO, so this never blocks.
+static void clear_status(void) {
+    i2c_hw_t *hw = i2c_get_hw(TOUCH_I2C);
+    hw->data_cmd = (GT911_STATUS >> 8) & 0xFF;
+    hw->data_cmd = GT911_STATUS & 0xFF;
+    hw->data_cmd = 0 | I2C_IC_DATA_CMD_STOP_BITS;
+}
+
+// The GT911 reports in portrait panel coordinates; undo the MADCTL
+// mapping so points line up with what is drawn in any rotation
+static void panel_to_display(uint16_t *x, uint16_t *y) {
+    uint16_t px = *x < TFT_PANEL_WIDTH ? *x : TFT_PANEL_WIDTH - 1;
+    uint16_t py = *y < TFT_PANEL_HEIGHT ? *y : TFT_PANEL_HEIGHT - 1;
+    *x = px;
+    *y = py;
+    switch (tft_rotation()) {
+        case TFT_ROTATE_90:
+            *x = py;
+            *y = TFT_PANEL_WIDTH - 1 - px;
+            break;
+        case TFT_ROTATE_180:
+            *x = TFT_PANEL_WIDTH - 1 - px;
+            *y = TFT_PANEL_HEIGHT - 1 - py;
+            break;
+        case TFT_ROTATE_270:
+            *x = TFT_PANEL_HEIGHT - 1 - py;
+            *y = px;
+            break;
+    }
+}
+
+static void queue_event(uint8_t type, uint8_t id, uint16_t x, uint16_t y) {
+    panel_to_display(&x, &y);
+    touch_event_t event = {report_time_us, x, y, id, type};
+    spsc_push(&event_queue, &event);
+}
+
+// Turn a fresh report into down/move/up events against the previous one
+static void process_report(void) {
+    uint8_t status = report[0];
+    if (!(status & 0x80)) return; // Buffer not ready
+
+    uint8_t count = status & 0x0F;
+    if (count > TOUCH_MAX_POINTS) count = TOUCH_MAX_POINTS;
+
+    uint16_t ids = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        const uint8_t *p = &report[(GT911_POINT1 - GT911_STATUS) + i * GT911_POINT_SIZE];
+        uint8_t id = p[0] & 0x0F;
+        uint16_t x = p[1] | (p[2] << 8);
+        uint16_t y = p[3] | (p[4] << 8);
+
+        if (!(last_ids & (1u << id))) {
+            queue_event(TOUCH_DOWN, id, x, y);
+        } else if (last_points[id].x != x || last_points[id].y != y) {
+            queue_event(TOUCH_MOVE, id, x, y);
+        }
+
+        ids |= 1u << id;
+        last_points[id].x = x;
+        last_points[id].y = y;
+    }
+
+    uint16_t lifted = last_ids & ~ids;
+    for (uint8_t id = 0; lifted; id++, lifted >>= 1) {
+        if (lifted & 1) {
+            queue_event(TOUCH_UP, id, last_points[id].x, last_points[id].y);
+        }
+    }
+
+    last_ids = ids;
+    active_count = count;
+    clear_status();
+}
+
+// ===== INTERRUPT HANDLERS =====
+
+static void touch_dma_irq(void) {
+    if (!dma_channel_get_irq1_status(rx_chan)) return;
+    dma_channel_acknowledge_irq1(rx_chan);
+    TRACE_ASYNC_END(TOUCH_READ);
+
+    process_report();
+    read_busy = false;
+
+    // INT fired again while we were reading
+    if (read_again) {
+        start_report_read();
+    }
+}
+
+static void touch_gpio_irq(void) {
+    if (!(gpio_get_irq_event_mask(TOUCH_INT) & gpio_events)) return;
+    gpio_acknowledge_irq(TOUCH_INT, gpio_events);
+
+    report_time_us = time_us_64();
+    if (read_busy) {
+        read_again = true;
+    } else {
+        start_report_read();
+    }
+}
+
+// ===== PUBLIC API =====
+
+bool touch_init(void) {
+    // Initialize I2C for touch
+    i2c_init(TOUCH_I2C, 400 * 1000); // 400 kHz
+    gpio_set_function(TOUCH_SDA, GPIO_FUNC_I2C);
+    gpio_set_function(TOUCH_SCL, GPIO_FUNC_I2C);
+    gpio_pull_up(TOUCH_SDA);
+    gpio_pull_up(TOUCH_SCL);
+
+    // Ask the controller which INT edge/level it signals reports with
+    uint8_t reg[2] = {(GT911_SWITCH1 >> 8) & 0xFF, GT911_SWITCH1 & 0xFF};
+    uint8_t switch1;
+    if (i2c_write_blocking(TOUCH_I2C, GT911_ADDR, reg, 2, true) < 0 ||
+        i2c_read_blocking(TOUCH_I2C, GT911_ADDR, &switch1, 1, false) < 0) {
+        printf("GT911 not responding\n");
+        return false;
+    }
+    switch (switch1 & 0x03) {
+        case 0:  gpio_events = GPIO_IRQ_EDGE_RISE; break;
+        case 1:  gpio_events = GPIO_IRQ_EDGE_FALL; break;
+        case 2:  gpio_events = GPIO_IRQ_EDGE_FALL; break; // Low level
+        default: gpio_events = GPIO_IRQ_EDGE_RISE; break; // High level
+    }
+
+    // Pre-build the burst read of status + all point records
+    read_cmds[0] = (GT911_STATUS >> 8) & 0xFF;
+    read_cmds[1] = GT911_STATUS & 0xFF;
+    for (uint8_t i = 0; i < REPORT_LEN; i++) {
+        read_cmds[2 + i] = I2C_IC_DATA_CMD_CMD_BITS;
+    }
+    read_cmds[2] |= I2C_IC_DATA_CMD_RESTART_BITS;
+    read_cmds[2 + REPORT_LEN - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+
+    spsc_init(&event_queue, event_storage, sizeof(touch_event_t), EVENT_QUEUE_LEN);
+
+    // Every transfer goes to the GT911; the address can only change
+    // while the block is disabled, so set it now while the bus is idle
+    i2c_hw_t *hw = i2c_get_hw(TOUCH_I2C);
+    hw->enable = 0;
+    hw->tar = GT911_ADDR;
+    hw->enable = 1;
+
+    // TX channel feeds commands, RX channel collects the report
+    tx_chan = dma_claim_unused_channel(true);
+    rx_chan = dma_claim_unused_channel(true);
+
+    dma_channel_config c = dma_channel_get_default_config(tx_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, i2c_get_dreq(TOUCH_I2C, true));
+    dma_channel_configure(tx_chan, &c, &hw->data_cmd, read_cmds, 2 + REPORT_LEN, false);
+
+    c = dma_channel_get_default_config(rx_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_dreq(&c, i2c_get_dreq(TOUCH_I2C, false));
+    dma_channel_configure(rx_chan, &c, report, &hw->data_cmd, REPORT_LEN, false);
+
+    dma_channel_set_irq1_enabled(rx_chan, true);
+    irq_add_shared_handler(DMA_IRQ_1, touch_dma_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_1, true);
+
+    // INT line from the controller
+    gpio_init(TOUCH_INT);
+    gpio_set_dir(TOUCH_INT, GPIO_IN);
+    gpio_add_raw_irq_handler(TOUCH_INT, touch_gpio_irq);
+    gpio_set_irq_enabled(TOUCH_INT, gpio_events, true);
+    irq_set_enabled(IO_IRQ_BANK0, true);
+
+    printf("Touch GT911 initialized\n");
+    return true;
+}
+
+bool touch_poll_event(touch_event_t *event) {
+    // touch_init() failed: no channels, no queue
+    if (tx_chan < 0) return false;
+
+    // Recover from a transfer the controller never completed. Reads only
+    // start on INT, and the controller may hold INT until its status is
+    // cleared, so read again straight away: the new report's completion
+    // clears the status. Toggling the block flushes whatever the aborted
+    // transfer left in its FIFOs; the target address survives it.
+    if (read_busy && time_us_64() - read_started_us > READ_TIMEOUT_US) {
+        uint32_t save = save_and_disable_interrupts();
+        dma_channel_abort(tx_chan);
+        dma_channel_abort(rx_chan);
+        i2c_hw_t *hw = i2c_get_hw(TOUCH_I2C);
+        (void)hw->clr_tx_abrt;
+        hw->enable = 0;
+        hw->enable = 1;
+        TRACE_ASYNC_END(TOUCH_READ);
+        start_report_read();
+        restore_interrupts(save);
+    }
+
+    return spsc_pop(&event_queue, event);
+}
+
+uint8_t touch_active_count(void) {
+    return active_count;
+}
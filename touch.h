@@ -0,0 +1,35 @@
+#ifndef TOUCH_H
+#define TOUCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// GT911 reports up to five simultaneous points
+#define TOUCH_MAX_POINTS 5
+
+typedef enum {
+    TOUCH_DOWN,
+    TOUCH_MOVE,
+    TOUCH_UP
+} touch_event_type_t;
+
+typedef struct {
+    uint64_t time_us;         // When the controller signalled the report
+    uint16_t x;               // Display coordinates, in the current
+    uint16_t y;               // tft_rotation like everything drawn
+    uint8_t id;               // GT911 track id, stable while the finger is down
+    uint8_t type;             // touch_event_type_t
+} touch_event_t;
+
+// Set up I2C, the INT line and DMA. Reports are read in the background
+// only when the controller raises INT. False if the controller does not
+// answer; touch_poll_event() then never reports anything.
+bool touch_init(void);
+
+// Drain the next queued event; returns false when the queue is empty
+bool touch_poll_event(touch_event_t *event);
+
+// Number of fingers currently down
+uint8_t touch_active_count(void);
+
+#endif // TOUCH_H
@@ -0,0 +1,151 @@
+#include "trace.h"
+
+#ifdef TRACE_ENABLED
+
+#include "spsc.h"
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include <string.h>
+
+// Wire format, little-endian, one packet per drain per core:
+//   "LGTR"  magic
+//   u8      type (TRACE_PACKET_*)
+//   u8      core
+//   u16     count
+//   u32     records dropped since the previous events packet
+//   ...     count trace_record_t, or count names as u8 length + chars
+//   u16     Fletcher-16 of everything from type to the end of the payload
+// The magic and checksum let the decoder pick packets out of a capture
+// that also holds ordinary printf output.
+#define TRACE_PACKET_NAMES  0
+#define TRACE_PACKET_EVENTS 1
+
+#define TRACE_PACKET_MAX    128           // Records per packet
+#define TRACE_NAMES_US      1000000       // Resend the name table this often
+
+#define TRACE_CORES         2
+
+_Static_assert(sizeof(trace_record_t) == 8, "trace records are 8 bytes on the wire");
+
+static trace_record_t ring_storage[TRACE_CORES][TRACE_RING_LEN];
+static spsc_t rings[TRACE_CORES];
+static atomic_uint dropped[TRACE_CORES];
+static uint32_t dropped_sent[TRACE_CORES];
+static uint64_t names_sent_us;
+static bool names_sent = false;
+
+static const char *const zone_names[TRACE_ZONE_COUNT] = {
+#define TRACE_ZONE_NAME(id, name) name,
+    TRACE_ZONES(TRACE_ZONE_NAME)
+#undef TRACE_ZONE_NAME
+};
+
+void trace_init(void) {
+    for (uint8_t c = 0; c < TRACE_CORES; c++) {
+        spsc_init(&rings[c], ring_storage[c], sizeof(trace_record_t), TRACE_RING_LEN);
+    }
+}
+
+// Each core only writes its own ring. IRQs are masked for the few
+// instructions of the push, since a handler on the same core may trace too.
+void trace_event(uint8_t zone, uint8_t kind) {
+    uint core = get_core_num();
+    trace_record_t rec = {time_us_32(), zone, kind, 0};
+
+    uint32_t irq = save_and_disable_interrupts();
+    if (!spsc_push(&rings[core], &rec)) {
+        atomic_fetch_add_explicit(&dropped[core], 1, memory_order_relaxed);
+    }
+    restore_interrupts(irq);
+}
+
+// ===== DRAIN =====
+
+typedef struct {
+    uint16_t sum1;
+    uint16_t sum2;
+} fletcher_t;
+
+static void put_byte(fletcher_t *f, uint8_t b) {
+    putchar_raw(b);
+    f->sum1 = (f->sum1 + b) % 255;
+    f->sum2 = (f->sum2 + f->sum1) % 255;
+}
+
+static void put_bytes(fletcher_t *f, const void *data, uint32_t len) {
+    const uint8_t *p = data;
+    for (uint32_t i = 0; i < len; i++) put_byte(f, p[i]);
+}
+
+static void put_header(fletcher_t *f, uint8_t type, uint8_t core, uint16_t count, uint32_t lost) {
+    putchar_raw('L');
+    putchar_raw('G');
+    putchar_raw('T');
+    putchar_raw('R');
+
+    uint8_t header[8] = {
+        type, core, count & 0xFF, count >> 8,
+        lost & 0xFF, (lost >> 8) & 0xFF, (lost >> 16) & 0xFF, lost >> 24,
+    };
+    f->sum1 = f->sum2 = 0;
+    put_bytes(f, header, sizeof(header));
+}
+
+static void put_checksum(const fletcher_t *f) {
+    uint16_t sum = (f->sum2 << 8) | f->sum1;
+    putchar_raw(sum & 0xFF);
+    putchar_raw(sum >> 8);
+}
+
+static void send_names(void) {
+    fletcher_t f;
+    put_header(&f, TRACE_PACKET_NAMES, 0, TRACE_ZONE_COUNT, 0);
+    for (uint8_t i = 0; i < TRACE_ZONE_COUNT; i++) {
+        uint8_t len = (uint8_t)strlen(zone_names[i]);
+        put_byte(&f, len);
+        put_bytes(&f, zone_names[i], len);
+    }
+    put_checksum(&f);
+}
+
+static void send_events(uint8_t core) {
+    trace_record_t batch[TRACE_PACKET_MAX];
+    uint16_t count = 0;
+    while (count < TRACE_PACKET_MAX && spsc_pop(&rings[core], &batch[count])) {
+        count++;
+    }
+
+    uint32_t total = atomic_load_explicit(&dropped[core], memory_order_relaxed);
+    uint32_t lost = total - dropped_sent[core];
+    if (count == 0 && lost == 0) return;
+    dropped_sent[core] = total;
+
+    // Records are already little-endian in memory on both targets
+    fletcher_t f;
+    put_header(&f, TRACE_PACKET_EVENTS, core, count, lost);
+    put_bytes(&f, batch, count * sizeof(trace_record_t));
+    put_checksum(&f);
+}
+
+void trace_drain(void) {
+    TRACE_ZONE(DRAIN);
+
+    // A capture may start at any time, so the names are repeated
+    uint64_t now = time_us_64();
+    if (!names_sent || now - names_sent_us >= TRACE_NAMES_US) {
+        send_names();
+        names_sent = true;
+        names_sent_us = now;
+    }
+
+    // At most one ring's worth per core, so a core that keeps tracing
+    // cannot hold the drain here
+    for (uint8_t core = 0; core < TRACE_CORES; core++) {
+        for (uint16_t i = 0; i < TRACE_RING_LEN / TRACE_PACKET_MAX; i++) {
+            send_events(core);
+            if (spsc_empty(&rings[core])) break;
+        }
+    }
+}
+
+#endif // TRACE_ENABLED
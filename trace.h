@@ -0,0 +1,91 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+// Timeline tracing (-DLIL_GUY_TRACE=ON). Zones are timestamped into a
+// ring per core and drained over USB as binary packets; tools/trace2json.py
+// turns a serial capture into Chrome/Perfetto trace JSON. When tracing is
+// off every macro below compiles to nothing.
+
+// Every zone and marker; the names travel with the trace
+#define TRACE_ZONES(X)                          \
+    X(UPDATE,           "update")               \
+    X(INPUT,            "input")                \
+    X(JOYSTICK,         "joystick")             \
+    X(POST,             "post")                 \
+    X(SLEEP,            "sleep")                \
+    X(DRAIN,            "trace_drain")          \
+    X(TOUCH_READ,       "touch_read")           \
+    X(AUDIO_MIX,        "audio_mix")            \
+    X(RENDER_WAIT,      "render_wait")          \
+    X(RENDER_DRAW,      "render_draw")          \
+    X(RENDER_PRESENT,   "render_present")
+
+typedef enum {
+#define TRACE_ZONE_ID(id, name) TRACE_##id,
+    TRACE_ZONES(TRACE_ZONE_ID)
+#undef TRACE_ZONE_ID
+    TRACE_ZONE_COUNT
+} trace_zone_t;
+
+// Record kinds
+enum {
+    TRACE_KIND_BEGIN,
+    TRACE_KIND_END,
+    TRACE_KIND_INSTANT,
+    TRACE_KIND_ASYNC_BEGIN,   // Spans that start and end in different
+    TRACE_KIND_ASYNC_END      // contexts, e.g. an IRQ-driven transfer
+};
+
+// One ring entry, and the wire format of an event
+typedef struct {
+    uint32_t time_us;         // Low 32 bits of time_us_64()
+    uint8_t zone;
+    uint8_t kind;
+    uint16_t reserved;
+} trace_record_t;
+
+#ifdef TRACE_ENABLED
+
+// Records kept per core between drains; older ones are kept and newer
+// ones dropped (and counted) when a ring fills
+#define TRACE_RING_LEN 1024
+
+void trace_init(void);
+void trace_event(uint8_t zone, uint8_t kind);
+
+// Send everything recorded so far (core0, outside IRQs)
+void trace_drain(void);
+
+static inline void trace_zone_exit(const uint8_t *zone) {
+    trace_event(*zone, TRACE_KIND_END);
+}
+
+// Zone lasting until the end of the enclosing block
+#define TRACE_ZONE(id) \
+    __attribute__((cleanup(trace_zone_exit), unused)) const uint8_t trace_zone_##id = \
+        (trace_event(TRACE_##id, TRACE_KIND_BEGIN), TRACE_##id)
+
+#define TRACE_BEGIN(id)         trace_event(TRACE_##id, TRACE_KIND_BEGIN)
+#define TRACE_END(id)           trace_event(TRACE_##id, TRACE_KIND_END)
+#define TRACE_INSTANT(id)       trace_event(TRACE_##id, TRACE_KIND_INSTANT)
+#define TRACE_ASYNC_BEGIN(id)   trace_event(TRACE_##id, TRACE_KIND_ASYNC_BEGIN)
+#define TRACE_ASYNC_END(id)     trace_event(TRACE_##id, TRACE_KIND_ASYNC_END)
+#define TRACE_INIT()            trace_init()
+#define TRACE_DRAIN()           trace_drain()
+
+#else
+
+#define TRACE_ZONE(id)
+#define TRACE_BEGIN(id)         ((void)0)
+#define TRACE_END(id)           ((void)0)
+#define TRACE_INSTANT(id)       ((void)0)
+#define TRACE_ASYNC_BEGIN(id)   ((void)0)
+#define TRACE_ASYNC_END(id)     ((void)0)
+#define TRACE_INIT()            ((void)0)
+#define TRACE_DRAIN()           ((void)0)
+
+#endif // TRACE_ENABLED
+
+#endif // TRACE_H
@@ -0,0 +1,153 @@
+#include "display.h"
+#include "pico/stdlib.h"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+
+// Tear-free presentation. The ST7796 refreshes its memory rows top to
+// bottom (in panel memory order) once per period and pulses TE when a
+// refresh ends. From the last pulse and the measured period we know
+// roughly which row is being scanned; a write is held back until the scan
+// has left the rows it touches, so it lands entirely between two passes.
+
+#define TFT_CMD_TEON            0x35
+
+// Scan lines per refresh beyond the visible rows (front and back porch,
+// with some margin since the exact values are not read back)
+#define VSYNC_PORCH_LINES       8
+
+// Pixels per millisecond the bus sustains, to estimate how long a write
+// takes (62.5 MHz SPI or PIO, 16 bits a pixel, less command overhead)
+#define VSYNC_PX_PER_MS         3600
+
+static tft_vsync_stats_t stats;
+
+#ifdef TFT_TE
+
+// Written by the TE interrupt on core0, read by the presenting core
+static volatile uint32_t te_count;
+static volatile uint32_t te_time_us;
+static volatile uint32_t te_period_us;
+
+static uint32_t last_present_refresh;
+
+static void vsync_te_irq(void) {
+    if (!(gpio_get_irq_event_mask(TFT_TE) & GPIO_IRQ_EDGE_RISE)) return;
+    gpio_acknowledge_irq(TFT_TE, GPIO_IRQ_EDGE_RISE);
+
+    uint32_t now = time_us_32();
+    if (te_count > 0) {
+        // Smooth out interrupt latency: 1/8 of each new measurement
+        uint32_t period = now - te_time_us;
+        te_period_us = te_period_us ? te_period_us - te_period_us / 8 + period / 8 : period;
+    }
+    te_time_us = now;
+    te_count++;
+}
+
+// Consistent view of the pulse counter, time and period
+static void vsync_snapshot(uint32_t *count, uint32_t *time, uint32_t *period) {
+    do {
+        *count = te_count;
+        *time = te_time_us;
+        *period = te_period_us;
+    } while (*count != te_count);
+}
+
+// Panel memory rows a logical rectangle covers under the current rotation
+static void vsync_rows(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t *r0, uint16_t *r1) {
+    uint8_t rotation = tft_rotation();
+    int16_t lo = rotation & 1 ? x : y;
+    int16_t hi = lo + (rotation & 1 ? w : h) - 1;
+
+    // 180 and 270 degrees mirror the row order
+    if (rotation >= TFT_ROTATE_180) {
+        int16_t t = lo;
+        lo = TFT_PANEL_HEIGHT - 1 - hi;
+        hi = TFT_PANEL_HEIGHT - 1 - t;
+    }
+    *r0 = lo < 0 ? 0 : lo;
+    *r1 = hi >= TFT_PANEL_HEIGHT ? TFT_PANEL_HEIGHT - 1 : hi;
+}
+
+void tft_vsync_init(void) {
+    tft_write_command(TFT_CMD_TEON);
+    tft_write_data(0x00);    // Pulse on vertical blanking only
+
+    gpio_init(TFT_TE);
+    gpio_set_dir(TFT_TE, GPIO_IN);
+    gpio_add_raw_irq_handler(TFT_TE, vsync_te_irq);
+    gpio_set_irq_enabled(TFT_TE, GPIO_IRQ_EDGE_RISE, true);
+    irq_set_enabled(IO_IRQ_BANK0, true);
+}
+
+bool tft_vsync_enabled(void) {
+    return te_count >= 2;
+}
+
+void tft_vsync_begin(int16_t x, int16_t y, int16_t w, int16_t h, uint32_t pixels) {
+    stats.presents++;
+
+    uint32_t count, te, period;
+    vsync_snapshot(&count, &te, &period);
+    stats.vsyncs = count;
+    stats.period_us = period;
+    if (count < 2 || period == 0) return;
+
+    uint16_t r0, r1;
+    vsync_rows(x, y, w, h, &r0, &r1);
+
+    uint32_t line_us = period / (TFT_PANEL_HEIGHT + VSYNC_PORCH_LINES);
+    uint32_t span_us = (r1 - r0 + 1) * line_us;
+    uint32_t write_us = pixels * 1000 / VSYNC_PX_PER_MS;
+
+    // Start once the scan has left the rows, and finish before it gets
+    // back to them. A write too big for that gap can only trail the scan
+    // from the first row, which is tear-free only if it never catches up.
+    uint32_t start, slack;
+    if (span_us + write_us <= period) {
+        start = (VSYNC_PORCH_LINES + r1 + 1) * line_us;
+        slack = period - span_us - write_us;
+    } else {
+        start = (VSYNC_PORCH_LINES + r0 + 1) * line_us;
+        slack = 0;
+        stats.torn++;
+    }
+
+    uint32_t now = time_us_32();
+    uint32_t phase = (now - te) % period;
+    uint32_t late = (phase - start + period) % period;
+    uint32_t wait = late <= slack ? 0 : period - late;
+
+    uint32_t t0 = now;
+    while (time_us_32() - t0 < wait) {
+        tight_loop_contents();
+    }
+    stats.wait_us = wait;
+
+    // Frame pacing in whole refreshes since the previous present
+    uint32_t refresh = count + (now - te + wait) / period;
+    uint32_t gap = refresh - last_present_refresh;
+    if (stats.presents > 1 && gap > 0) {
+        stats.cadence[gap > 4 ? 3 : gap - 1]++;
+    }
+    last_present_refresh = refresh;
+}
+
+#else
+
+void tft_vsync_init(void) {
+}
+
+bool tft_vsync_enabled(void) {
+    return false;
+}
+
+void tft_vsync_begin(int16_t x, int16_t y, int16_t w, int16_t h, uint32_t pixels) {
+    stats.presents++;
+}
+
+#endif // TFT_TE
+
+const tft_vsync_stats_t* tft_vsync_stats(void) {
+    return &stats;
+}